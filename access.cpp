@@ -6,6 +6,8 @@
 #include "array.h"
 #include "file.h"
 #include "detail/manager.h"
+#include "detail/entry.h"
+#include "detail/retention.h"
 #include <iostream>
 #include <cstdlib>
 #include <cassert>
@@ -17,6 +19,34 @@ namespace CONFIG_NAMESPACE {
 namespace config {
 using namespace detail;
 
+namespace {
+
+// obtain entry for a compile-time key, using its precomputed hash
+template<class V>
+ValueEntry<V> *resolve(Manager *mgr, const Key<V> &key)
+{
+    auto entry = mgr->getValue<V>(key.hash(), key.path(), key.section(), key.name(), key.flags());
+    if (!entry)
+        return nullptr;
+    if (key.hasDefault()) {
+        entry->setOrCheckDefaultValue(V(key.defaultValue()));
+        entry->assign();
+    } else {
+        entry->checkDefaultValue();
+    }
+    return entry;
+}
+
+// entry referenced by handle, null if it has not been resolved by mgr
+template<class E>
+E *entry_for(Manager *mgr, const HandleBase &handle)
+{
+    assert(handle.valid());
+    return static_cast<E *>(mgr->entry(handle.id(), handle.generation()));
+}
+
+} // namespace
+
 Bridge::~Bridge() = default;
 
 bool Access::isInitialized()
@@ -24,6 +54,11 @@ bool Access::isInitialized()
     return Manager::exists();
 }
 
+void Access::retainConfiguration(bool enable)
+{
+    detail::RetainedConfigs::the().setEnabled(enable);
+}
+
 Access::Access(): Logger("Access")
 {
     m_manager = detail::Manager::the();
@@ -37,7 +72,7 @@ Access::Access(const std::string &host, const std::string &cluster, int rank): L
         m_manager = Manager::the();
         if (host != m_manager->hostname() || cluster != m_manager->cluster() || rank != m_manager->rank()) {
             if (rank == -1) {
-                debug() << "not changing rank " << m_manager->rank() << " to " << rank << std::endl;
+                CONFIG_DEBUG() << "not changing rank " << m_manager->rank() << " to " << rank << std::endl;
             } else if (m_manager->rank() == -1) {
                 m_manager->setRank(rank);
             } else {
@@ -121,80 +156,313 @@ std::unique_ptr<File> Access::file(const std::string &path) const
     return std::make_unique<File>(path, m_manager);
 }
 
+void Access::prefetch(const std::vector<std::string> &paths)
+{
+    assert(m_manager);
+    m_manager->prefetch(paths);
+}
+
+void Access::load(const std::vector<std::string> &paths)
+{
+    assert(m_manager);
+    m_manager->load(paths);
+}
+
+void Access::load(const std::vector<std::string> &paths, Collective &collective)
+{
+    assert(m_manager);
+    m_manager->load(paths, collective);
+}
+
 template<class V>
-ValuePtr<V> Access::value(const std::string &path, const std::string &section, const std::string &name)
+ValuePtr<V> Access::value(std::string_view path, std::string_view section, std::string_view name)
 {
     return std::make_unique<Value<V>>(path, section, name, m_manager);
 }
 
 template<class V>
-ValuePtr<V> Access::value(const std::string &path, const std::string &section, const std::string &name, const V &def,
+ValuePtr<V> Access::value(std::string_view path, std::string_view section, std::string_view name, const V &def,
                           Flag flags)
 {
     return std::make_unique<Value<V>>(path, section, name, def, m_manager, flags);
 }
 
 template<class V>
-std::unique_ptr<Array<V>> Access::array(const std::string &path, const std::string &section, const std::string &name)
+std::unique_ptr<Array<V>> Access::array(std::string_view path, std::string_view section, std::string_view name)
 {
     return std::make_unique<Array<V>>(path, section, name, m_manager);
 }
 
 template<class V>
-std::unique_ptr<Array<V>> Access::array(const std::string &path, const std::string &section, const std::string &name,
+std::unique_ptr<Array<V>> Access::array(std::string_view path, std::string_view section, std::string_view name,
                                         const std::vector<V> &def, Flag flags)
 {
     return std::make_unique<Array<V>>(path, section, name, def, m_manager, flags);
 }
 
-template std::unique_ptr<Value<bool>> Access::value<bool>(const std::string &path, const std::string &section,
-                                                          const std::string &name);
-template std::unique_ptr<Value<int64_t>> Access::value<int64_t>(const std::string &path, const std::string &section,
-                                                                const std::string &name);
-template std::unique_ptr<Value<double>> Access::value<double>(const std::string &path, const std::string &section,
-                                                              const std::string &name);
+template<class V>
+ValueHandle<V> Access::valueHandle(std::string_view path, std::string_view section, std::string_view name)
+{
+    auto entry = m_manager->getValue<V>(path, section, name, Flag::Default);
+    if (!entry)
+        return ValueHandle<V>();
+    entry->checkDefaultValue();
+    return ValueHandle<V>(entry->handle(), m_manager->generation());
+}
+
+template<class V>
+ValueHandle<V> Access::valueHandle(std::string_view path, std::string_view section, std::string_view name,
+                                   const V &def, Flag flags)
+{
+    auto entry = m_manager->getValue<V>(path, section, name, flags);
+    if (!entry)
+        return ValueHandle<V>();
+    entry->setOrCheckDefaultValue(def);
+    entry->assign();
+    return ValueHandle<V>(entry->handle(), m_manager->generation());
+}
+
+template<class V>
+ArrayHandle<V> Access::arrayHandle(std::string_view path, std::string_view section, std::string_view name)
+{
+    auto entry = m_manager->getArray<V>(path, section, name, Flag::Default);
+    if (!entry)
+        return ArrayHandle<V>();
+    entry->checkDefaultValue();
+    return ArrayHandle<V>(entry->handle(), m_manager->generation());
+}
+
+template<class V>
+ArrayHandle<V> Access::arrayHandle(std::string_view path, std::string_view section, std::string_view name,
+                                   const std::vector<V> &def, Flag flags)
+{
+    auto entry = m_manager->getArray<V>(path, section, name, flags);
+    if (!entry)
+        return ArrayHandle<V>();
+    typename ArrayEntry<V>::ArrayType val(def.begin(), def.end());
+    entry->setOrCheckDefaultValue(val);
+    entry->assign();
+    return ArrayHandle<V>(entry->handle(), m_manager->generation());
+}
+
+template<class V>
+ValuePtr<V> Access::value(const Key<V> &key)
+{
+    auto entry = resolve(m_manager, key);
+    if (!entry)
+        return nullptr;
+    return ValuePtr<V>(new Value<V>(entry));
+}
+
+template<class V>
+ValueHandle<V> Access::valueHandle(const Key<V> &key)
+{
+    auto entry = resolve(m_manager, key);
+    if (!entry)
+        return ValueHandle<V>();
+    return ValueHandle<V>(entry->handle(), m_manager->generation());
+}
+
+template<class V>
+ValuePtr<V> Access::value(ValueHandle<V> handle)
+{
+    auto entry = entry_for<ValueEntry<V>>(m_manager, handle);
+    if (!entry)
+        return nullptr;
+    return ValuePtr<V>(new Value<V>(entry));
+}
+
+template<class V>
+std::unique_ptr<Array<V>> Access::array(ArrayHandle<V> handle)
+{
+    auto entry = entry_for<ArrayEntry<V>>(m_manager, handle);
+    if (!entry)
+        return nullptr;
+    return std::unique_ptr<Array<V>>(new Array<V>(entry));
+}
+
+template<class V>
+const V &Access::get(ValueHandle<V> handle) const
+{
+    auto entry = entry_for<ValueEntry<V>>(m_manager, handle);
+    if (!entry) {
+        static const V invalid{};
+        return invalid;
+    }
+    return entry->value();
+}
+
+template<class V>
+V Access::snapshot(ValueHandle<V> handle) const
+{
+    auto entry = entry_for<ValueEntry<V>>(m_manager, handle);
+    if (!entry)
+        return V();
+    return entry->snapshot();
+}
+
+template<class V>
+std::vector<V> Access::get(ArrayHandle<V> handle) const
+{
+    auto entry = entry_for<ArrayEntry<V>>(m_manager, handle);
+    if (!entry)
+        return std::vector<V>();
+    const auto val = entry->snapshot();
+    return std::vector<V>(val.begin(), val.end());
+}
+
+template<class V>
+void Access::set(ValueHandle<V> handle, const V &value)
+{
+    if (auto entry = entry_for<ValueEntry<V>>(m_manager, handle))
+        *entry = value;
+}
+
+template<class V>
+void Access::set(ArrayHandle<V> handle, const std::vector<V> &value)
+{
+    auto entry = entry_for<ArrayEntry<V>>(m_manager, handle);
+    if (!entry)
+        return;
+    typename ArrayEntry<V>::ArrayType val(value.begin(), value.end());
+    *entry = val;
+}
+
+template std::unique_ptr<Value<bool>> Access::value<bool>(std::string_view path, std::string_view section,
+                                                          std::string_view name);
+template std::unique_ptr<Value<int64_t>> Access::value<int64_t>(std::string_view path, std::string_view section,
+                                                                std::string_view name);
+template std::unique_ptr<Value<double>> Access::value<double>(std::string_view path, std::string_view section,
+                                                              std::string_view name);
 template std::unique_ptr<Value<std::string>>
-Access::value<std::string>(const std::string &path, const std::string &section, const std::string &name);
+Access::value<std::string>(std::string_view path, std::string_view section, std::string_view name);
 template std::unique_ptr<Value<config::Section>>
-Access::value<config::Section>(const std::string &path, const std::string &section, const std::string &name);
-
-template std::unique_ptr<Value<bool>> Access::value(const std::string &path, const std::string &section,
-                                                    const std::string &name, const bool &def, Flag flags);
-template std::unique_ptr<Value<int64_t>> Access::value(const std::string &path, const std::string &section,
-                                                       const std::string &name, const int64_t &def, Flag flags);
-template std::unique_ptr<Value<double>> Access::value(const std::string &path, const std::string &section,
-                                                      const std::string &name, const double &def, Flag flags);
-template std::unique_ptr<Value<std::string>> Access::value(const std::string &path, const std::string &section,
-                                                           const std::string &name, const std::string &def, Flag flags);
-template std::unique_ptr<Value<config::Section>> Access::value(const std::string &path, const std::string &section,
-                                                               const std::string &name, const config::Section &def,
+Access::value<config::Section>(std::string_view path, std::string_view section, std::string_view name);
+
+template std::unique_ptr<Value<bool>> Access::value(std::string_view path, std::string_view section,
+                                                    std::string_view name, const bool &def, Flag flags);
+template std::unique_ptr<Value<int64_t>> Access::value(std::string_view path, std::string_view section,
+                                                       std::string_view name, const int64_t &def, Flag flags);
+template std::unique_ptr<Value<double>> Access::value(std::string_view path, std::string_view section,
+                                                      std::string_view name, const double &def, Flag flags);
+template std::unique_ptr<Value<std::string>> Access::value(std::string_view path, std::string_view section,
+                                                           std::string_view name, const std::string &def, Flag flags);
+template std::unique_ptr<Value<config::Section>> Access::value(std::string_view path, std::string_view section,
+                                                               std::string_view name, const config::Section &def,
                                                                Flag flags);
 
-template std::unique_ptr<Array<bool>> Access::array(const std::string &path, const std::string &section,
-                                                    const std::string &name);
-template std::unique_ptr<Array<int64_t>> Access::array(const std::string &path, const std::string &section,
-                                                       const std::string &name);
-template std::unique_ptr<Array<double>> Access::array(const std::string &path, const std::string &section,
-                                                      const std::string &name);
-template std::unique_ptr<Array<std::string>> Access::array(const std::string &path, const std::string &section,
-                                                           const std::string &name);
-template std::unique_ptr<Array<config::Section>> Access::array(const std::string &path, const std::string &section,
-                                                               const std::string &name);
-
-template std::unique_ptr<Array<bool>> Access::array(const std::string &path, const std::string &section,
-                                                    const std::string &name, const std::vector<bool> &def, Flag flags);
-template std::unique_ptr<Array<int64_t>> Access::array(const std::string &path, const std::string &section,
-                                                       const std::string &name, const std::vector<int64_t> &def,
+template std::unique_ptr<Array<bool>> Access::array(std::string_view path, std::string_view section,
+                                                    std::string_view name);
+template std::unique_ptr<Array<int64_t>> Access::array(std::string_view path, std::string_view section,
+                                                       std::string_view name);
+template std::unique_ptr<Array<double>> Access::array(std::string_view path, std::string_view section,
+                                                      std::string_view name);
+template std::unique_ptr<Array<std::string>> Access::array(std::string_view path, std::string_view section,
+                                                           std::string_view name);
+template std::unique_ptr<Array<config::Section>> Access::array(std::string_view path, std::string_view section,
+                                                               std::string_view name);
+
+template std::unique_ptr<Array<bool>> Access::array(std::string_view path, std::string_view section,
+                                                    std::string_view name, const std::vector<bool> &def, Flag flags);
+template std::unique_ptr<Array<int64_t>> Access::array(std::string_view path, std::string_view section,
+                                                       std::string_view name, const std::vector<int64_t> &def,
                                                        Flag flags);
-template std::unique_ptr<Array<double>> Access::array(const std::string &path, const std::string &section,
-                                                      const std::string &name, const std::vector<double> &def,
+template std::unique_ptr<Array<double>> Access::array(std::string_view path, std::string_view section,
+                                                      std::string_view name, const std::vector<double> &def,
                                                       Flag flags);
-template std::unique_ptr<Array<std::string>> Access::array(const std::string &path, const std::string &section,
-                                                           const std::string &name, const std::vector<std::string> &def,
+template std::unique_ptr<Array<std::string>> Access::array(std::string_view path, std::string_view section,
+                                                           std::string_view name, const std::vector<std::string> &def,
                                                            Flag flags);
-template std::unique_ptr<Array<config::Section>> Access::array(const std::string &path, const std::string &section,
-                                                               const std::string &name,
+template std::unique_ptr<Array<config::Section>> Access::array(std::string_view path, std::string_view section,
+                                                               std::string_view name,
                                                                const std::vector<config::Section> &def, Flag flags);
+
+template ValueHandle<bool> Access::valueHandle<bool>(std::string_view path, std::string_view section,
+                                                     std::string_view name);
+template ValueHandle<int64_t> Access::valueHandle<int64_t>(std::string_view path, std::string_view section,
+                                                           std::string_view name);
+template ValueHandle<double> Access::valueHandle<double>(std::string_view path, std::string_view section,
+                                                         std::string_view name);
+template ValueHandle<std::string> Access::valueHandle<std::string>(std::string_view path, std::string_view section,
+                                                                   std::string_view name);
+template ValueHandle<config::Section>
+    Access::valueHandle<config::Section>(std::string_view path, std::string_view section, std::string_view name);
+template ValueHandle<bool> Access::valueHandle(std::string_view path, std::string_view section, std::string_view name,
+                                               const bool &def, Flag flags);
+template ValueHandle<int64_t> Access::valueHandle(std::string_view path, std::string_view section,
+                                                  std::string_view name, const int64_t &def, Flag flags);
+template ValueHandle<double> Access::valueHandle(std::string_view path, std::string_view section, std::string_view name,
+                                                 const double &def, Flag flags);
+template ValueHandle<std::string> Access::valueHandle(std::string_view path, std::string_view section,
+                                                      std::string_view name, const std::string &def, Flag flags);
+template ValueHandle<config::Section> Access::valueHandle(std::string_view path, std::string_view section,
+                                                          std::string_view name, const config::Section &def,
+                                                          Flag flags);
+template ArrayHandle<bool> Access::arrayHandle<bool>(std::string_view path, std::string_view section,
+                                                     std::string_view name);
+template ArrayHandle<int64_t> Access::arrayHandle<int64_t>(std::string_view path, std::string_view section,
+                                                           std::string_view name);
+template ArrayHandle<double> Access::arrayHandle<double>(std::string_view path, std::string_view section,
+                                                         std::string_view name);
+template ArrayHandle<std::string> Access::arrayHandle<std::string>(std::string_view path, std::string_view section,
+                                                                   std::string_view name);
+template ArrayHandle<config::Section>
+    Access::arrayHandle<config::Section>(std::string_view path, std::string_view section, std::string_view name);
+template ArrayHandle<bool> Access::arrayHandle(std::string_view path, std::string_view section, std::string_view name,
+                                               const std::vector<bool> &def, Flag flags);
+template ArrayHandle<int64_t> Access::arrayHandle(std::string_view path, std::string_view section,
+                                                  std::string_view name, const std::vector<int64_t> &def, Flag flags);
+template ArrayHandle<double> Access::arrayHandle(std::string_view path, std::string_view section, std::string_view name,
+                                                 const std::vector<double> &def, Flag flags);
+template ArrayHandle<std::string> Access::arrayHandle(std::string_view path, std::string_view section,
+                                                      std::string_view name, const std::vector<std::string> &def,
+                                                      Flag flags);
+template ArrayHandle<config::Section> Access::arrayHandle(std::string_view path, std::string_view section,
+                                                          std::string_view name,
+                                                          const std::vector<config::Section> &def, Flag flags);
+template std::unique_ptr<Value<bool>> Access::value(const Key<bool> &key);
+template std::unique_ptr<Value<int64_t>> Access::value(const Key<int64_t> &key);
+template std::unique_ptr<Value<double>> Access::value(const Key<double> &key);
+template std::unique_ptr<Value<std::string>> Access::value(const Key<std::string> &key);
+template ValueHandle<bool> Access::valueHandle(const Key<bool> &key);
+template ValueHandle<int64_t> Access::valueHandle(const Key<int64_t> &key);
+template ValueHandle<double> Access::valueHandle(const Key<double> &key);
+template ValueHandle<std::string> Access::valueHandle(const Key<std::string> &key);
+template std::unique_ptr<Value<bool>> Access::value(ValueHandle<bool> handle);
+template std::unique_ptr<Value<int64_t>> Access::value(ValueHandle<int64_t> handle);
+template std::unique_ptr<Value<double>> Access::value(ValueHandle<double> handle);
+template std::unique_ptr<Value<std::string>> Access::value(ValueHandle<std::string> handle);
+template std::unique_ptr<Value<config::Section>> Access::value(ValueHandle<config::Section> handle);
+template std::unique_ptr<Array<bool>> Access::array(ArrayHandle<bool> handle);
+template std::unique_ptr<Array<int64_t>> Access::array(ArrayHandle<int64_t> handle);
+template std::unique_ptr<Array<double>> Access::array(ArrayHandle<double> handle);
+template std::unique_ptr<Array<std::string>> Access::array(ArrayHandle<std::string> handle);
+template std::unique_ptr<Array<config::Section>> Access::array(ArrayHandle<config::Section> handle);
+template const bool &Access::get(ValueHandle<bool> handle) const;
+template const int64_t &Access::get(ValueHandle<int64_t> handle) const;
+template const double &Access::get(ValueHandle<double> handle) const;
+template const std::string &Access::get(ValueHandle<std::string> handle) const;
+template const config::Section &Access::get(ValueHandle<config::Section> handle) const;
+template bool Access::snapshot(ValueHandle<bool> handle) const;
+template int64_t Access::snapshot(ValueHandle<int64_t> handle) const;
+template double Access::snapshot(ValueHandle<double> handle) const;
+template std::string Access::snapshot(ValueHandle<std::string> handle) const;
+template config::Section Access::snapshot(ValueHandle<config::Section> handle) const;
+template std::vector<bool> Access::get(ArrayHandle<bool> handle) const;
+template std::vector<int64_t> Access::get(ArrayHandle<int64_t> handle) const;
+template std::vector<double> Access::get(ArrayHandle<double> handle) const;
+template std::vector<std::string> Access::get(ArrayHandle<std::string> handle) const;
+template std::vector<config::Section> Access::get(ArrayHandle<config::Section> handle) const;
+template void Access::set(ValueHandle<bool> handle, const bool &value);
+template void Access::set(ValueHandle<int64_t> handle, const int64_t &value);
+template void Access::set(ValueHandle<double> handle, const double &value);
+template void Access::set(ValueHandle<std::string> handle, const std::string &value);
+template void Access::set(ValueHandle<config::Section> handle, const config::Section &value);
+template void Access::set(ArrayHandle<bool> handle, const std::vector<bool> &value);
+template void Access::set(ArrayHandle<int64_t> handle, const std::vector<int64_t> &value);
+template void Access::set(ArrayHandle<double> handle, const std::vector<double> &value);
+template void Access::set(ArrayHandle<std::string> handle, const std::vector<std::string> &value);
+template void Access::set(ArrayHandle<config::Section> handle, const std::vector<config::Section> &value);
 } // namespace config
 #ifdef CONFIG_NAMESPACE
 }
@@ -6,12 +6,15 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
 #include <functional>
 #include "detail/export.h"
 #include "detail/flags.h"
 #include "detail/logger.h"
+#include "handle.h"
+#include "key.h"
 
 #ifdef CONFIG_NAMESPACE
 namespace CONFIG_NAMESPACE {
@@ -24,6 +27,7 @@ class Manager;
 }
 class File;
 class ConfigBase;
+class Collective;
 
 /// provide a bridge for retrieving and storing per-model configuration values
 /** When configuration entries tagged with Flag::PerModel are changed, the registered bridge is notified of this via \ref Bridge::wasChanged.
@@ -43,6 +47,8 @@ public:
 class COVEXPORT Access: detail::Logger {
 public:
     static bool isInitialized(); ///< check if Access has already been initialized with the non-default constructor
+    static void retainConfiguration(
+        bool enable = true); ///< keep parsed files for reuse by later instances once the last Access is gone
 
     Access(); ///< initiate access to configuration system with default search path only
     Access(const std::string &host, const std::string &cluster,
@@ -58,86 +64,226 @@ public:
     bool save(); ///< save changes in all files that should be saved on exit
 
     std::unique_ptr<File> file(const std::string &path) const; ///< get interface to a configuration file
+    void prefetch(const std::vector<std::string> &paths); ///< start loading configuration files in the background
+    void load(const std::vector<std::string> &paths); ///< load configuration files concurrently and wait for them
+    void load(const std::vector<std::string> &paths,
+              Collective &collective); ///< load configuration files on root of collective and broadcast them
 
     template<class V>
-    ValuePtr<V> value(const std::string &path, const std::string &section,
-                      const std::string &name); ///< query existing configuration value
+    ValuePtr<V> value(std::string_view path, std::string_view section,
+                      std::string_view name); ///< query existing configuration value
     template<class V>
-    ValuePtr<V> value(const std::string &path, const std::string &section, const std::string &name, const V &def,
+    ValuePtr<V> value(std::string_view path, std::string_view section, std::string_view name, const V &def,
                       Flag flags = Flag::Default); ///< create configuration value with the provided default
 
     template<class V>
-    std::unique_ptr<Array<V>> array(const std::string &path, const std::string &section,
-                                    const std::string &name); ///< query existing configuration array
+    std::unique_ptr<Array<V>> array(std::string_view path, std::string_view section,
+                                    std::string_view name); ///< query existing configuration array
     template<class V>
     std::unique_ptr<Array<V>>
-    array(const std::string &path, const std::string &section, const std::string &name, const std::vector<V> &def,
+    array(std::string_view path, std::string_view section, std::string_view name, const std::vector<V> &def,
           Flag flags = Flag::Default); ///< create configuration array with the provided default
 
+    template<class V>
+    ValueHandle<V> valueHandle(std::string_view path, std::string_view section,
+                               std::string_view name); ///< resolve existing configuration value for repeated access
+    template<class V>
+    ValueHandle<V> valueHandle(std::string_view path, std::string_view section, std::string_view name, const V &def,
+                               Flag flags = Flag::Default); ///< resolve configuration value with the provided default
+    template<class V>
+    ArrayHandle<V> arrayHandle(std::string_view path, std::string_view section,
+                               std::string_view name); ///< resolve existing configuration array for repeated access
+    template<class V>
+    ArrayHandle<V> arrayHandle(std::string_view path, std::string_view section, std::string_view name,
+                               const std::vector<V> &def,
+                               Flag flags = Flag::Default); ///< resolve configuration array with the provided default
+
+    template<class V>
+    ValuePtr<V> value(const Key<V> &key); ///< configuration value for compile-time key, null on type mismatch
+    template<class V>
+    ValueHandle<V> valueHandle(const Key<V> &key); ///< resolve configuration value for compile-time key
+
+    template<class V>
+    ValuePtr<V> value(ValueHandle<V> handle); ///< configuration value for resolved handle, e.g. for setting an updater
+    template<class V>
+    std::unique_ptr<Array<V>> array(ArrayHandle<V> handle); ///< configuration array for resolved handle
+    template<class V>
+    const V &get(ValueHandle<V> handle) const; ///< retrieve value via resolved handle
+    template<class V>
+    V snapshot(ValueHandle<V> handle) const; ///< retrieve copy of value via resolved handle, safe while others assign
+    template<class V>
+    std::vector<V> get(ArrayHandle<V> handle) const; ///< retrieve all array values via resolved handle
+    template<class V>
+    void set(ValueHandle<V> handle, const V &value); ///< assign value via resolved handle
+    template<class V>
+    void set(ArrayHandle<V> handle, const std::vector<V> &value); ///< assign array of values via resolved handle
+
 private:
     Bridge *m_bridge = nullptr;
     detail::Manager *m_manager = nullptr;
 };
 
 extern template std::unique_ptr<Value<bool>>
-    COVEXPORT Access::value<bool>(const std::string &path, const std::string &section, const std::string &name);
+    COVEXPORT Access::value<bool>(std::string_view path, std::string_view section, std::string_view name);
 extern template std::unique_ptr<Value<int64_t>>
-    COVEXPORT Access::value<int64_t>(const std::string &path, const std::string &section, const std::string &name);
+    COVEXPORT Access::value<int64_t>(std::string_view path, std::string_view section, std::string_view name);
 extern template std::unique_ptr<Value<double>>
-    COVEXPORT Access::value<double>(const std::string &path, const std::string &section, const std::string &name);
+    COVEXPORT Access::value<double>(std::string_view path, std::string_view section, std::string_view name);
 extern template std::unique_ptr<Value<std::string>>
-    COVEXPORT Access::value<std::string>(const std::string &path, const std::string &section, const std::string &name);
+    COVEXPORT Access::value<std::string>(std::string_view path, std::string_view section, std::string_view name);
 extern template std::unique_ptr<Value<config::Section>> COVEXPORT
-Access::value<config::Section>(const std::string &path, const std::string &section, const std::string &name);
-extern template std::unique_ptr<Value<bool>> COVEXPORT Access::value(const std::string &path,
-                                                                     const std::string &section,
-                                                                     const std::string &name, const bool &def,
+Access::value<config::Section>(std::string_view path, std::string_view section, std::string_view name);
+extern template std::unique_ptr<Value<bool>> COVEXPORT Access::value(std::string_view path,
+                                                                     std::string_view section,
+                                                                     std::string_view name, const bool &def,
                                                                      Flag flags);
-extern template std::unique_ptr<Value<int64_t>> COVEXPORT Access::value(const std::string &path,
-                                                                        const std::string &section,
-                                                                        const std::string &name, const int64_t &def,
+extern template std::unique_ptr<Value<int64_t>> COVEXPORT Access::value(std::string_view path,
+                                                                        std::string_view section,
+                                                                        std::string_view name, const int64_t &def,
                                                                         Flag flags);
-extern template std::unique_ptr<Value<double>> COVEXPORT Access::value(const std::string &path,
-                                                                       const std::string &section,
-                                                                       const std::string &name, const double &def,
+extern template std::unique_ptr<Value<double>> COVEXPORT Access::value(std::string_view path,
+                                                                       std::string_view section,
+                                                                       std::string_view name, const double &def,
                                                                        Flag flags);
-extern template std::unique_ptr<Value<std::string>> COVEXPORT Access::value(const std::string &path,
-                                                                            const std::string &section,
-                                                                            const std::string &name,
+extern template std::unique_ptr<Value<std::string>> COVEXPORT Access::value(std::string_view path,
+                                                                            std::string_view section,
+                                                                            std::string_view name,
                                                                             const std::string &def, Flag flags);
-extern template std::unique_ptr<Value<config::Section>> COVEXPORT Access::value(const std::string &path,
-                                                                                const std::string &section,
-                                                                                const std::string &name,
+extern template std::unique_ptr<Value<config::Section>> COVEXPORT Access::value(std::string_view path,
+                                                                                std::string_view section,
+                                                                                std::string_view name,
                                                                                 const config::Section &def, Flag flags);
 
 extern template std::unique_ptr<Array<bool>>
-    COVEXPORT Access::array(const std::string &path, const std::string &section, const std::string &name);
+    COVEXPORT Access::array(std::string_view path, std::string_view section, std::string_view name);
 extern template std::unique_ptr<Array<int64_t>>
-    COVEXPORT Access::array(const std::string &path, const std::string &section, const std::string &name);
+    COVEXPORT Access::array(std::string_view path, std::string_view section, std::string_view name);
 extern template std::unique_ptr<Array<double>>
-    COVEXPORT Access::array(const std::string &path, const std::string &section, const std::string &name);
+    COVEXPORT Access::array(std::string_view path, std::string_view section, std::string_view name);
 extern template std::unique_ptr<Array<std::string>>
-    COVEXPORT Access::array(const std::string &path, const std::string &section, const std::string &name);
+    COVEXPORT Access::array(std::string_view path, std::string_view section, std::string_view name);
 extern template std::unique_ptr<Array<config::Section>>
-    COVEXPORT Access::array(const std::string &path, const std::string &section, const std::string &name);
-extern template std::unique_ptr<Array<bool>> COVEXPORT Access::array(const std::string &path,
-                                                                     const std::string &section,
-                                                                     const std::string &name,
+    COVEXPORT Access::array(std::string_view path, std::string_view section, std::string_view name);
+extern template std::unique_ptr<Array<bool>> COVEXPORT Access::array(std::string_view path,
+                                                                     std::string_view section,
+                                                                     std::string_view name,
                                                                      const std::vector<bool> &def, Flag flags);
-extern template std::unique_ptr<Array<int64_t>> COVEXPORT Access::array(const std::string &path,
-                                                                        const std::string &section,
-                                                                        const std::string &name,
+extern template std::unique_ptr<Array<int64_t>> COVEXPORT Access::array(std::string_view path,
+                                                                        std::string_view section,
+                                                                        std::string_view name,
                                                                         const std::vector<int64_t> &def, Flag flags);
-extern template std::unique_ptr<Array<double>> COVEXPORT Access::array(const std::string &path,
-                                                                       const std::string &section,
-                                                                       const std::string &name,
+extern template std::unique_ptr<Array<double>> COVEXPORT Access::array(std::string_view path,
+                                                                       std::string_view section,
+                                                                       std::string_view name,
                                                                        const std::vector<double> &def, Flag flags);
 extern template std::unique_ptr<Array<std::string>>
-    COVEXPORT Access::array(const std::string &path, const std::string &section, const std::string &name,
+    COVEXPORT Access::array(std::string_view path, std::string_view section, std::string_view name,
                             const std::vector<std::string> &def, Flag flags);
 extern template std::unique_ptr<Array<config::Section>>
-    COVEXPORT Access::array(const std::string &path, const std::string &section, const std::string &name,
+    COVEXPORT Access::array(std::string_view path, std::string_view section, std::string_view name,
                             const std::vector<config::Section> &def, Flag flags);
+
+extern template ValueHandle<bool> COVEXPORT Access::valueHandle<bool>(std::string_view path, std::string_view section,
+                                                                      std::string_view name);
+extern template ValueHandle<int64_t> COVEXPORT Access::valueHandle<int64_t>(std::string_view path,
+                                                                            std::string_view section,
+                                                                            std::string_view name);
+extern template ValueHandle<double> COVEXPORT Access::valueHandle<double>(std::string_view path,
+                                                                          std::string_view section,
+                                                                          std::string_view name);
+extern template ValueHandle<std::string>
+    COVEXPORT Access::valueHandle<std::string>(std::string_view path, std::string_view section, std::string_view name);
+extern template ValueHandle<config::Section>
+    COVEXPORT Access::valueHandle<config::Section>(std::string_view path, std::string_view section,
+                                                   std::string_view name);
+extern template ValueHandle<bool> COVEXPORT Access::valueHandle(std::string_view path, std::string_view section,
+                                                                std::string_view name, const bool &def, Flag flags);
+extern template ValueHandle<int64_t> COVEXPORT Access::valueHandle(std::string_view path, std::string_view section,
+                                                                   std::string_view name, const int64_t &def,
+                                                                   Flag flags);
+extern template ValueHandle<double> COVEXPORT Access::valueHandle(std::string_view path, std::string_view section,
+                                                                  std::string_view name, const double &def, Flag flags);
+extern template ValueHandle<std::string> COVEXPORT Access::valueHandle(std::string_view path, std::string_view section,
+                                                                       std::string_view name, const std::string &def,
+                                                                       Flag flags);
+extern template ValueHandle<config::Section> COVEXPORT Access::valueHandle(std::string_view path,
+                                                                           std::string_view section,
+                                                                           std::string_view name,
+                                                                           const config::Section &def, Flag flags);
+extern template ArrayHandle<bool> COVEXPORT Access::arrayHandle<bool>(std::string_view path, std::string_view section,
+                                                                      std::string_view name);
+extern template ArrayHandle<int64_t> COVEXPORT Access::arrayHandle<int64_t>(std::string_view path,
+                                                                            std::string_view section,
+                                                                            std::string_view name);
+extern template ArrayHandle<double> COVEXPORT Access::arrayHandle<double>(std::string_view path,
+                                                                          std::string_view section,
+                                                                          std::string_view name);
+extern template ArrayHandle<std::string>
+    COVEXPORT Access::arrayHandle<std::string>(std::string_view path, std::string_view section, std::string_view name);
+extern template ArrayHandle<config::Section>
+    COVEXPORT Access::arrayHandle<config::Section>(std::string_view path, std::string_view section,
+                                                   std::string_view name);
+extern template ArrayHandle<bool> COVEXPORT Access::arrayHandle(std::string_view path, std::string_view section,
+                                                                std::string_view name, const std::vector<bool> &def,
+                                                                Flag flags);
+extern template ArrayHandle<int64_t> COVEXPORT Access::arrayHandle(std::string_view path, std::string_view section,
+                                                                   std::string_view name,
+                                                                   const std::vector<int64_t> &def, Flag flags);
+extern template ArrayHandle<double> COVEXPORT Access::arrayHandle(std::string_view path, std::string_view section,
+                                                                  std::string_view name, const std::vector<double> &def,
+                                                                  Flag flags);
+extern template ArrayHandle<std::string> COVEXPORT Access::arrayHandle(std::string_view path, std::string_view section,
+                                                                       std::string_view name,
+                                                                       const std::vector<std::string> &def, Flag flags);
+extern template ArrayHandle<config::Section> COVEXPORT Access::arrayHandle(std::string_view path,
+                                                                           std::string_view section,
+                                                                           std::string_view name,
+                                                                           const std::vector<config::Section> &def,
+                                                                           Flag flags);
+extern template std::unique_ptr<Value<bool>> COVEXPORT Access::value(const Key<bool> &key);
+extern template std::unique_ptr<Value<int64_t>> COVEXPORT Access::value(const Key<int64_t> &key);
+extern template std::unique_ptr<Value<double>> COVEXPORT Access::value(const Key<double> &key);
+extern template std::unique_ptr<Value<std::string>> COVEXPORT Access::value(const Key<std::string> &key);
+extern template ValueHandle<bool> COVEXPORT Access::valueHandle(const Key<bool> &key);
+extern template ValueHandle<int64_t> COVEXPORT Access::valueHandle(const Key<int64_t> &key);
+extern template ValueHandle<double> COVEXPORT Access::valueHandle(const Key<double> &key);
+extern template ValueHandle<std::string> COVEXPORT Access::valueHandle(const Key<std::string> &key);
+extern template std::unique_ptr<Value<bool>> COVEXPORT Access::value(ValueHandle<bool> handle);
+extern template std::unique_ptr<Value<int64_t>> COVEXPORT Access::value(ValueHandle<int64_t> handle);
+extern template std::unique_ptr<Value<double>> COVEXPORT Access::value(ValueHandle<double> handle);
+extern template std::unique_ptr<Value<std::string>> COVEXPORT Access::value(ValueHandle<std::string> handle);
+extern template std::unique_ptr<Value<config::Section>> COVEXPORT Access::value(ValueHandle<config::Section> handle);
+extern template std::unique_ptr<Array<bool>> COVEXPORT Access::array(ArrayHandle<bool> handle);
+extern template std::unique_ptr<Array<int64_t>> COVEXPORT Access::array(ArrayHandle<int64_t> handle);
+extern template std::unique_ptr<Array<double>> COVEXPORT Access::array(ArrayHandle<double> handle);
+extern template std::unique_ptr<Array<std::string>> COVEXPORT Access::array(ArrayHandle<std::string> handle);
+extern template std::unique_ptr<Array<config::Section>> COVEXPORT Access::array(ArrayHandle<config::Section> handle);
+extern template COVEXPORT const bool &Access::get(ValueHandle<bool> handle) const;
+extern template COVEXPORT const int64_t &Access::get(ValueHandle<int64_t> handle) const;
+extern template COVEXPORT const double &Access::get(ValueHandle<double> handle) const;
+extern template COVEXPORT const std::string &Access::get(ValueHandle<std::string> handle) const;
+extern template COVEXPORT const config::Section &Access::get(ValueHandle<config::Section> handle) const;
+extern template bool COVEXPORT Access::snapshot(ValueHandle<bool> handle) const;
+extern template int64_t COVEXPORT Access::snapshot(ValueHandle<int64_t> handle) const;
+extern template double COVEXPORT Access::snapshot(ValueHandle<double> handle) const;
+extern template std::string COVEXPORT Access::snapshot(ValueHandle<std::string> handle) const;
+extern template config::Section COVEXPORT Access::snapshot(ValueHandle<config::Section> handle) const;
+extern template std::vector<bool> COVEXPORT Access::get(ArrayHandle<bool> handle) const;
+extern template std::vector<int64_t> COVEXPORT Access::get(ArrayHandle<int64_t> handle) const;
+extern template std::vector<double> COVEXPORT Access::get(ArrayHandle<double> handle) const;
+extern template std::vector<std::string> COVEXPORT Access::get(ArrayHandle<std::string> handle) const;
+extern template std::vector<config::Section> COVEXPORT Access::get(ArrayHandle<config::Section> handle) const;
+extern template void COVEXPORT Access::set(ValueHandle<bool> handle, const bool &value);
+extern template void COVEXPORT Access::set(ValueHandle<int64_t> handle, const int64_t &value);
+extern template void COVEXPORT Access::set(ValueHandle<double> handle, const double &value);
+extern template void COVEXPORT Access::set(ValueHandle<std::string> handle, const std::string &value);
+extern template void COVEXPORT Access::set(ValueHandle<config::Section> handle, const config::Section &value);
+extern template void COVEXPORT Access::set(ArrayHandle<bool> handle, const std::vector<bool> &value);
+extern template void COVEXPORT Access::set(ArrayHandle<int64_t> handle, const std::vector<int64_t> &value);
+extern template void COVEXPORT Access::set(ArrayHandle<double> handle, const std::vector<double> &value);
+extern template void COVEXPORT Access::set(ArrayHandle<std::string> handle, const std::vector<std::string> &value);
+extern template void COVEXPORT Access::set(ArrayHandle<config::Section> handle,
+                                           const std::vector<config::Section> &value);
 } // namespace config
 #ifdef CONFIG_NAMESPACE
 }
@@ -16,7 +16,7 @@ namespace config {
 using namespace detail;
 
 template<class V>
-Array<V>::Array(const std::string &path, const std::string &section, const std::string &name, detail::Manager *mgr)
+Array<V>::Array(std::string_view path, std::string_view section, std::string_view name, detail::Manager *mgr)
 : ConfigBase("Array")
 {
     if (!mgr)
@@ -27,7 +27,7 @@ Array<V>::Array(const std::string &path, const std::string &section, const std::
 }
 
 template<class V>
-Array<V>::Array(const std::string &path, const std::string &section, const std::string &name,
+Array<V>::Array(std::string_view path, std::string_view section, std::string_view name,
                 const std::vector<V> &value, detail::Manager *mgr, Flag flags)
 : ConfigBase("Array")
 {
@@ -39,7 +39,8 @@ Array<V>::Array(const std::string &path, const std::string &section, const std::
         val[i] = value[i];
     }
     entry()->setOrCheckDefaultValue(val);
-    debug() << key() << " initialized to " << entry()->value() << " (default: " << defaultValue() << ")" << std::endl;
+    CONFIG_DEBUG() << key() << " initialized to " << entry()->value() << " (default: " << defaultValue() << ")"
+                   << std::endl;
     entry()->addObserver(this);
     entry()->assign();
 }
@@ -66,7 +67,7 @@ ArrayEntry<V> *Array<V>::entry() const
 template<class V>
 size_t Array<V>::size() const
 {
-    return entry()->size();
+    return entry()->snapshotSize();
 }
 
 template<class V>
@@ -78,7 +79,7 @@ void Array<V>::resize(size_t size)
 template<class V>
 V Array<V>::operator[](size_t index) const
 {
-    return entry()->at(index);
+    return entry()->snapshotAt(index);
 }
 
 template<class V>
@@ -97,8 +98,8 @@ ValueProxy<V> &ValueProxy<V>::operator=(const V &value)
 template<class V>
 ValueProxy<V> Array<V>::operator[](size_t index)
 {
-    if (index >= size()) {
-        debug("operator[]") << "resizing from " << size() << " for access at " << index << std::endl;
+    if (index >= entry()->size()) {
+        CONFIG_DEBUG("operator[]") << "resizing from " << entry()->size() << " for access at " << index << std::endl;
         resize(index + 1);
     }
     ValueProxy vp{this, index};
@@ -118,9 +119,9 @@ ValueProxy<V>::~ValueProxy()
 template<class V>
 Array<V> &Array<V>::operator=(const std::vector<V> &val)
 {
-    if (size() != val.size())
+    if (entry()->size() != val.size())
         resize(val.size());
-    for (size_t c = 0; c < size(); ++c) {
+    for (size_t c = 0; c < entry()->size(); ++c) {
         if (V(entry()->at(c)) != val[c]) {
             entry()->at(c) = val[c];
             entry()->setModified();
@@ -133,11 +134,8 @@ Array<V> &Array<V>::operator=(const std::vector<V> &val)
 template<class V>
 std::vector<V> Array<V>::value() const
 {
-    std::vector<V> vec(size());
-    for (size_t c = 0; c < size(); ++c) {
-        vec[c] = entry()->at(c);
-    }
-    return vec;
+    const auto val = entry()->snapshot();
+    return std::vector<V>(val.begin(), val.end());
 }
 
 template<class V>
@@ -152,13 +150,8 @@ std::vector<V> Array<V>::defaultValue() const
 template<class V>
 void Array<V>::update()
 {
-    auto &str = debug("update");
-    str << key() << ": have updater: " << (m_updater ? "yes" : "no");
-    str << " {";
-    for (auto v: entry()->value())
-        str << " " << v;
-    str << " }";
-    str << std::endl;
+    CONFIG_DEBUG("update") << key() << ": have updater: " << (m_updater ? "yes" : "no") << " " << entry()->value()
+                           << std::endl;
     if (m_updater)
         m_updater();
 }
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <functional>
 #include "detail/export.h"
 #include "detail/flags.h"
@@ -57,6 +58,7 @@ All array members have to be of the same type, even though this is not required
 */
 template<class V>
 class Array: public ConfigBase {
+    friend class Access;
     friend class detail::ArrayEntry<V>;
     friend class detail::ValueProxy<V>;
 
@@ -66,21 +68,21 @@ public:
     Array() = delete;
     Array(const Array &other) =
         delete; ///< removed as copying does not work well when functor objects are provided via \ref setUpdater
-    Array(const std::string &path, const std::string &section, const std::string &name,
+    Array(std::string_view path, std::string_view section, std::string_view name,
           detail::Manager *mgr = nullptr); ///< retrieve existing array via Manager mgr (or the default manager)
-    Array(const std::string &path, const std::string &section, const std::string &name, const std::vector<V> &value,
+    Array(std::string_view path, std::string_view section, std::string_view name, const std::vector<V> &value,
           detail::Manager *mgr = nullptr,
           Flag flags = Flag::Default); ///< retrieve array or initialize to `value`
     ~Array() override;
     void setUpdater(std::function<void()> func); ///< set `func` to be notified when size or an entry changes
-    size_t size() const; ///< retrieve number of values
+    size_t size() const; ///< retrieve number of values, may be called while other threads assign
     void resize(
         size_t
             size); ///< change number of values, newly created entries will be set to the default value provided at construction time
-    V operator[](size_t index) const; ///< retrieve value with @param index
+    V operator[](size_t index) const; ///< retrieve value with @param index, safe while others assign
     ValueProxy operator[](size_t index); ///< change value of @param index
     Array &operator=(const std::vector<V> &val); ///< assign array of values
-    std::vector<V> value() const; ///< retrieve all values
+    std::vector<V> value() const; ///< retrieve all values, may be called while other threads assign
     std::vector<V> defaultValue() const; ///< retrieve default values
 
 private:
@@ -0,0 +1,100 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+// time creation of distinct values from an increasing number of threads:
+// throughput should grow with the number of threads, as they do not serialize on a common lock
+
+#include "../access.h"
+#include "../value.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace config;
+
+namespace {
+
+const int EntriesPerThread = 20000;
+
+} // namespace
+
+int main()
+{
+    const auto dir = std::filesystem::temp_directory_path() / ("covconfig-bench-" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir / "user");
+    // search only generated files and never save into the real user configuration
+#ifdef _WIN32
+    _putenv_s("COVCONFIG", dir.string().c_str());
+    _putenv_s("XDG_CONFIG_HOME", (dir / "user").string().c_str());
+#else
+    setenv("COVCONFIG", dir.string().c_str(), 1);
+    setenv("XDG_CONFIG_HOME", (dir / "user").string().c_str(), 1);
+#endif
+
+    const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned n = 1; n < maxThreads; n *= 2)
+        counts.push_back(n);
+    counts.push_back(maxThreads);
+
+    // every round creates entries in its own section of the file, so that all of them are new
+    {
+        std::ofstream f(dir / "create.toml");
+        for (unsigned n: counts) {
+            for (unsigned t = 0; t < n; ++t) {
+                f << "[round" << n << ".thread" << t << "]\n";
+                for (int i = 0; i < EntriesPerThread; ++i)
+                    f << "value" << i << " = " << i << "\n";
+            }
+        }
+    }
+
+    std::cout << std::setw(10) << "threads" << std::setw(20) << "entries/s" << std::setw(12) << "speedup"
+              << std::endl;
+    {
+        Access access("", "");
+        // load file before timing
+        access.value<int64_t>("create", "round1.thread0", "value0");
+
+        double single = 0.;
+        for (unsigned n: counts) {
+            std::vector<std::thread> threads;
+            const auto start = std::chrono::steady_clock::now();
+            for (unsigned t = 0; t < n; ++t) {
+                threads.emplace_back([&access, n, t]() {
+                    const std::string section = "round" + std::to_string(n) + ".thread" + std::to_string(t);
+                    for (int i = 0; i < EntriesPerThread; ++i)
+                        access.value<int64_t>("create", section, "value" + std::to_string(i));
+                });
+            }
+            for (auto &t: threads)
+                t.join();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            const double rate = n * EntriesPerThread / elapsed.count();
+            if (n == 1)
+                single = rate;
+            std::cout << std::setw(10) << n << std::setw(20) << std::fixed << std::setprecision(0) << rate
+                      << std::setw(12) << std::setprecision(2) << rate / single << std::endl;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    return 0;
+}
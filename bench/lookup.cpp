@@ -0,0 +1,103 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+// time creation of values from configuration files of increasing size:
+// cost per entry should not depend on the size of the file it is read from
+
+#include "../access.h"
+#include "../value.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace config;
+
+namespace {
+
+const int ValuesPerSection = 8;
+const int Lookups = 1000;
+
+void writeConfig(const std::filesystem::path &file, int sections)
+{
+    std::ofstream f(file);
+    for (int s = 0; s < sections; ++s) {
+        f << "[section" << s << "]\n";
+        for (int v = 0; v < ValuesPerSection; ++v)
+            f << "value" << v << " = " << s * ValuesPerSection + v << "\n";
+    }
+}
+
+} // namespace
+
+int main()
+{
+    const auto dir = std::filesystem::temp_directory_path() / ("covconfig-bench-" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir / "user");
+    // search only generated files and never save into the real user configuration
+#ifdef _WIN32
+    _putenv_s("COVCONFIG", dir.string().c_str());
+    _putenv_s("XDG_CONFIG_HOME", (dir / "user").string().c_str());
+#else
+    setenv("COVCONFIG", dir.string().c_str(), 1);
+    setenv("XDG_CONFIG_HOME", (dir / "user").string().c_str(), 1);
+#endif
+
+    const std::vector<int> sizes{10, 100, 1000, 10000, 100000};
+    for (int sections: sizes)
+        writeConfig(dir / ("lookup" + std::to_string(sections) + ".toml"), sections);
+
+    std::cout << std::setw(10) << "sections" << std::setw(12) << "file [KiB]" << std::setw(16) << "create [ns]"
+              << std::setw(16) << "lookup [ns]" << std::endl;
+    {
+        Access access("", "");
+        for (int sections: sizes) {
+            const std::string path = "lookup" + std::to_string(sections);
+            const auto size = std::filesystem::file_size(dir / (path + ".toml"));
+            // load file before timing
+            access.value<int64_t>(path, "section0", "value0");
+
+            // spread entries evenly across the file
+            const int n = std::min(Lookups, sections * ValuesPerSection - 1);
+            std::vector<std::string> names(n + 1), sectionNames(n + 1);
+            for (int i = 1; i <= n; ++i) {
+                const int idx = int(int64_t(i) * sections * ValuesPerSection / (n + 1));
+                sectionNames[i] = "section" + std::to_string(idx / ValuesPerSection);
+                names[i] = "value" + std::to_string(idx % ValuesPerSection);
+            }
+
+            // first access creates entries by looking up their TOML nodes
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 1; i <= n; ++i)
+                access.value<int64_t>(path, sectionNames[i], names[i]);
+            auto create = std::chrono::steady_clock::now() - start;
+
+            // later accesses find existing entries
+            start = std::chrono::steady_clock::now();
+            for (int i = 1; i <= n; ++i)
+                access.value<int64_t>(path, sectionNames[i], names[i]);
+            auto lookup = std::chrono::steady_clock::now() - start;
+
+            std::cout << std::setw(10) << sections << std::setw(12) << size / 1024 << std::setw(16)
+                      << std::chrono::duration_cast<std::chrono::nanoseconds>(create).count() / n << std::setw(16)
+                      << std::chrono::duration_cast<std::chrono::nanoseconds>(lookup).count() / n << std::endl;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    return 0;
+}
@@ -0,0 +1,43 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "collective.h"
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+
+Collective::~Collective() = default;
+
+int Collective::root() const
+{
+    return 0;
+}
+
+CallbackCollective::CallbackCollective(int rank, Broadcast broadcast, int root)
+: m_rank(rank), m_root(root), m_broadcast(broadcast)
+{}
+
+int CallbackCollective::rank() const
+{
+    return m_rank;
+}
+
+int CallbackCollective::root() const
+{
+    return m_root;
+}
+
+bool CallbackCollective::broadcast(std::string &data)
+{
+    if (!m_broadcast)
+        return false;
+    return m_broadcast(data, m_root);
+}
+
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -0,0 +1,53 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file collective.h
+/// share configuration files among the processes of a parallel job
+#pragma once
+
+#include <string>
+#include <functional>
+#include "detail/export.h"
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+
+/// transport for distributing configuration data from one process to all others
+/** Pass to \ref Access::load, so that only the \ref root process searches for and reads configuration files
+    common to all hosts, which are then broadcast to all other processes participating in the collective operation.
+    All participants have to call \ref Access::load with the same paths.
+    Host and cluster specific configuration files are still looked up by each process for its own hostname and cluster
+    and take precedence over the received files.
+ */
+class COVEXPORT Collective {
+public:
+    virtual ~Collective();
+    virtual int rank() const = 0; ///< rank of this process within the collective operation
+    virtual int root() const; ///< rank of the process that reads configuration files, 0 by default
+    virtual bool broadcast(
+        std::string &data) = 0; ///< replace data on all ranks with that of \ref root, return false on failure
+};
+
+/// \ref Collective forwarding to a broadcast function supplied by the application, e.g. wrapping MPI_Bcast
+class COVEXPORT CallbackCollective: public Collective {
+public:
+    typedef std::function<bool(std::string &data, int root)> Broadcast; ///< has to transmit size and contents
+
+    CallbackCollective(int rank, Broadcast broadcast, int root = 0);
+    int rank() const override;
+    int root() const override;
+    bool broadcast(std::string &data) override;
+
+private:
+    int m_rank = 0;
+    int m_root = 0;
+    Broadcast m_broadcast;
+};
+
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -25,5 +25,8 @@ namespace detail {}
 #endif
 
 #include "access.h"
+#include "collective.h"
+#include "handle.h"
+#include "key.h"
 #include "value.h"
 #include "array.h"
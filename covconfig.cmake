@@ -1,41 +1,112 @@
 set(COVCONFIG_SOURCES
     ${PREFIX}access.cpp
     ${PREFIX}array.cpp
+    ${PREFIX}collective.cpp
     ${PREFIX}file.cpp
     ${PREFIX}section.cpp
     ${PREFIX}value.cpp
     ${PREFIX}detail/base.cpp
+    ${PREFIX}detail/defaults.cpp
+    ${PREFIX}detail/dircache.cpp
     ${PREFIX}detail/entry.cpp
+    ${PREFIX}detail/lazysections.cpp
     ${PREFIX}detail/logger.cpp
     ${PREFIX}detail/manager.cpp
+    ${PREFIX}detail/mappedfile.cpp
     ${PREFIX}detail/observer.cpp
     ${PREFIX}detail/output.cpp
-    ${PREFIX}detail/tomlaccess.cpp)
+    ${PREFIX}detail/registry.cpp
+    ${PREFIX}detail/retention.cpp
+    ${PREFIX}detail/sharedcache.cpp
+    ${PREFIX}detail/tomlaccess.cpp
+    ${PREFIX}detail/treecache.cpp)
 
 set(COVCONFIG_HEADERS
     ${PREFIX}access.h
     ${PREFIX}array.h
+    ${PREFIX}collective.h
     ${PREFIX}file.h
+    ${PREFIX}handle.h
+    ${PREFIX}key.h
     ${PREFIX}section.h
     ${PREFIX}value.h
     ${PREFIX}config.h
     ${PREFIX}detail/output.h)
 set(COVCONFIG_DETAIL_HEADERS
     ${PREFIX}detail/base.h
+    ${PREFIX}detail/defaults.h
+    ${PREFIX}detail/dircache.h
     ${PREFIX}detail/entry.h
     ${PREFIX}detail/export.h
     ${PREFIX}detail/flags.h
+    ${PREFIX}detail/hash.h
+    ${PREFIX}detail/lazysections.h
     ${PREFIX}detail/logger.h
     ${PREFIX}detail/manager.h
     ${PREFIX}detail/manager_impl.h
+    ${PREFIX}detail/mappedfile.h
     ${PREFIX}detail/observer.h
     ${PREFIX}detail/output.h
-    ${PREFIX}detail/tomlaccess.h)
+    ${PREFIX}detail/registry.h
+    ${PREFIX}detail/retention.h
+    ${PREFIX}detail/sharedcache.h
+    ${PREFIX}detail/snapshot.h
+    ${PREFIX}detail/tomlaccess.h
+    ${PREFIX}detail/treecache.h
+    ${PREFIX}detail/typetag.h)
 
 set(COVCONFIG_PRIVATE_INCLUDES ${PREFIX}detail/toml/include)
 
+option(COVCONFIG_DEBUG_OUTPUT "Compile in debug output, to be enabled at runtime with COVCONFIG_DEBUG" ON)
+if(NOT COVCONFIG_DEBUG_OUTPUT)
+    set(COVCONFIG_PRIVATE_DEFINITIONS CONFIG_NO_DEBUG)
+endif()
+
 set(CMAKE_MODULE_PATH "${CMAKE_CURRENT_LIST_DIR}/cmake;${CMAKE_MODULE_PATH}")
 find_package(Filesystem)
 if(Filesystem_FOUND)
     set(COVCONFIG_PRIVATE_LIBRARIES std::filesystem)
 endif()
+
+# shm_open for node-local snapshots, part of libc with recent glibc
+find_library(COVCONFIG_RT_LIBRARY rt)
+mark_as_advanced(COVCONFIG_RT_LIBRARY)
+if(COVCONFIG_RT_LIBRARY)
+    list(APPEND COVCONFIG_PRIVATE_LIBRARIES ${COVCONFIG_RT_LIBRARY})
+endif()
+# dladdr/dlopen for keeping the library providing the process-wide snapshot cache loaded
+if(CMAKE_DL_LIBS)
+    list(APPEND COVCONFIG_PRIVATE_LIBRARIES ${CMAKE_DL_LIBS})
+endif()
+
+set(COVCONFIG_SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}")
+
+# covconfig_compile_defaults(<target> <file>.toml...)
+# compile default value overrides for configuration path <file> into constexpr tables of <target>,
+# which has to be built from COVCONFIG_SOURCES - replaces parsing of resource files at run time
+function(covconfig_compile_defaults TARGET)
+    if(NOT TARGET covconfig_gendefaults)
+        add_executable(covconfig_gendefaults ${COVCONFIG_SOURCE_DIR}/tools/gendefaults.cpp)
+        set_target_properties(covconfig_gendefaults PROPERTIES CXX_STANDARD 17 CXX_STANDARD_REQUIRED ON)
+        target_include_directories(covconfig_gendefaults PRIVATE ${COVCONFIG_SOURCE_DIR}/detail/toml/include)
+        if(Filesystem_FOUND)
+            target_link_libraries(covconfig_gendefaults PRIVATE std::filesystem)
+        endif()
+    endif()
+
+    set(files)
+    foreach(file ${ARGN})
+        get_filename_component(file ${file} ABSOLUTE)
+        list(APPEND files ${file})
+    endforeach()
+
+    set(output ${CMAKE_CURRENT_BINARY_DIR}/${TARGET}_compiled_defaults.cpp)
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND covconfig_gendefaults ${COVCONFIG_SOURCE_DIR}/detail/defaults.h ${output} ${files}
+        DEPENDS covconfig_gendefaults ${files}
+        COMMENT "Compiling configuration defaults for ${TARGET}"
+        VERBATIM)
+    target_sources(${TARGET} PRIVATE ${output})
+    target_compile_definitions(${TARGET} PRIVATE CONFIG_COMPILED_DEFAULTS)
+endfunction()
@@ -0,0 +1,43 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "defaults.h"
+
+#include <algorithm>
+#include <tuple>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+#ifdef CONFIG_COMPILED_DEFAULTS
+// generated by covconfig_compile_defaults
+extern const CompiledDefault compiled_defaults[];
+extern const size_t num_compiled_defaults;
+#endif
+
+// parameters are unused without compiled defaults
+const CompiledDefault *find_compiled_default([[maybe_unused]] std::string_view path,
+                                             [[maybe_unused]] std::string_view section,
+                                             [[maybe_unused]] std::string_view name)
+{
+#ifdef CONFIG_COMPILED_DEFAULTS
+    const auto key = std::make_tuple(path, section, name);
+    const auto begin = compiled_defaults, end = compiled_defaults + num_compiled_defaults;
+    auto it = std::lower_bound(begin, end, key, [](const CompiledDefault &d, const decltype(key) &k) {
+        return std::tie(d.path, d.section, d.name) < k;
+    });
+    if (it != end && it->path == path && it->section == section && it->name == name)
+        return it;
+#endif
+    return nullptr;
+}
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -0,0 +1,84 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file defaults.h
+/// default value overrides compiled from TOML files at build time
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "typetag.h"
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+/// literal representation of a scalar default value
+struct CompiledValue {
+    TypeTag type = TypeTag::Invalid;
+    bool boolean = false;
+    int64_t integer = 0;
+    double floating = 0.;
+    std::string_view string;
+};
+
+/// default for a value or an array, as generated by `covconfig_compile_defaults` (see covconfig.cmake)
+struct CompiledDefault {
+    std::string_view path; ///< configuration path
+    std::string_view section; ///< section within configuration, nested tables separated by `.`
+    std::string_view name; ///< name of value within section
+    CompiledValue value; ///< type is TypeTag::Array for arrays
+    const CompiledValue *elements = nullptr; ///< members of an array
+    size_t count = 0; ///< number of array members
+};
+
+/// check that table is sorted by path, section and name and free of duplicates, as required for lookups
+constexpr bool compiled_defaults_sorted(const CompiledDefault *defaults, size_t count)
+{
+    for (size_t i = 1; i < count; ++i) {
+        const auto &a = defaults[i - 1], &b = defaults[i];
+        if (a.path > b.path || (a.path == b.path && a.section > b.section) ||
+            (a.path == b.path && a.section == b.section && a.name >= b.name))
+            return false;
+    }
+    return true;
+}
+
+/// binary search of compiled defaults, null if not found or if library has been built without compiled defaults
+const CompiledDefault *find_compiled_default(std::string_view path, std::string_view section, std::string_view name);
+
+/// convert compiled value to V, if types match
+template<class V>
+std::optional<V> compiled_value(const CompiledValue &v)
+{
+    if constexpr (std::is_same<V, bool>::value) {
+        if (v.type == TypeTag::Bool)
+            return v.boolean;
+    } else if constexpr (std::is_same<V, int64_t>::value) {
+        if (v.type == TypeTag::Integer)
+            return v.integer;
+    } else if constexpr (std::is_same<V, double>::value) {
+        if (v.type == TypeTag::Double)
+            return v.floating;
+        if (v.type == TypeTag::Integer)
+            return double(v.integer);
+    } else if constexpr (std::is_same<V, std::string>::value) {
+        if (v.type == TypeTag::String)
+            return std::string(v.string);
+    }
+    return std::nullopt;
+}
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
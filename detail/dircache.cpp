@@ -0,0 +1,59 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "dircache.h"
+
+#include <filesystem>
+#include <system_error>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+namespace fs = std::filesystem;
+
+bool DirectoryCache::contains(const std::string &pathname)
+{
+    const fs::path p(pathname);
+    std::lock_guard guard(m_mutex);
+    const auto &l = listing(p.parent_path().string());
+    if (!l.exists)
+        return false;
+    return l.files.find(p.filename().string()) != l.files.end();
+}
+
+void DirectoryCache::clear()
+{
+    std::lock_guard guard(m_mutex);
+    m_listings.clear();
+}
+
+const DirectoryCache::Listing &DirectoryCache::listing(const std::string &dir)
+{
+    auto it = m_listings.find(dir);
+    if (it != m_listings.end())
+        return it->second;
+
+    Listing &l = m_listings[dir];
+    std::error_code ec;
+    fs::directory_iterator entries(dir, ec);
+    if (ec)
+        return l;
+    l.exists = true;
+    for (; !ec && entries != fs::directory_iterator(); entries.increment(ec)) {
+        // follows symbolic links, as opening the file would
+        std::error_code fec;
+        if (entries->is_regular_file(fec))
+            l.files.insert(entries->path().filename().string());
+    }
+    return l;
+}
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
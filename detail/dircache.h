@@ -0,0 +1,42 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file dircache.h
+/// cached listings of configuration search directories
+#pragma once
+
+#include <string>
+#include <set>
+#include <map>
+#include <mutex>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+/// answer whether files exist in search directories with a single directory scan per directory
+/** avoids probing each candidate file with open(), which is costly on shared filesystems when many processes start */
+class DirectoryCache {
+public:
+    bool contains(const std::string &pathname); ///< whether a regular file pathname exists, according to the cache
+    void clear(); ///< forget all listings, e.g. because search path changed
+
+private:
+    struct Listing {
+        bool exists = false; ///< whether the directory could be read
+        std::set<std::string> files; ///< names of contained regular files
+    };
+    const Listing &listing(const std::string &dir); ///< requires m_mutex to be held
+
+    std::mutex m_mutex;
+    std::map<std::string, Listing> m_listings;
+};
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
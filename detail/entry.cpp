@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include "entry.h"
+#include "defaults.h"
 #include "tomlaccess.h"
 #include "manager.h"
 #include "output.h"
@@ -9,6 +10,8 @@
 #include "../array.h"
 #include "../section.h"
 #include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
 
 #include "toml/toml.hpp"
 
@@ -37,10 +40,11 @@ std::string sectionForRank(const std::string &sec, int rank = -1)
 }
 } // namespace
 
-Entry::Entry(const std::string &classname, Manager *mgr, const std::string &path, const std::string &section,
-             const std::string &name, Flag flags)
+Entry::Entry(const std::string &classname, TypeTag type, Manager *mgr, const std::string &path,
+             const std::string &section, const std::string &name, Flag flags)
 : Logger(classname)
 , m_manager(mgr)
+, m_type(type)
 , m_path(path)
 , m_section(section)
 , m_name(name)
@@ -111,6 +115,27 @@ std::string Entry::key() const
     return k;
 }
 
+uint32_t Entry::handle() const
+{
+    return m_handle;
+}
+
+Manager *Entry::manager() const
+{
+    return m_manager;
+}
+
+const std::shared_ptr<Config> &Entry::config() const
+{
+    return m_config;
+}
+
+void Entry::materialize(const std::string &section)
+{
+    // values outside of any table are identified by their name
+    m_manager->materialize(*m_config, section.empty() ? m_name : section);
+}
+
 void Entry::setModified()
 {
     m_modified = true;
@@ -119,9 +144,11 @@ void Entry::setModified()
 void Entry::store()
 {
     if (m_modified) {
+        publish();
         assign();
         m_modified = false;
-        debug("store") << key() << ", notifying " << m_observers.size() << " observers" << std::endl;
+        std::lock_guard guard(m_observerMutex);
+        CONFIG_DEBUG("store") << key() << ", notifying " << m_observers.size() << " observers" << std::endl;
         for (auto *o: m_observers) {
             o->update();
         }
@@ -135,47 +162,58 @@ Flag Entry::flags() const
 
 void Entry::addObserver(Observer *o)
 {
+    std::lock_guard guard(m_observerMutex);
     m_observers.emplace(o);
-    debug("addObserver") << key() << ", now " << m_observers.size() << " observers" << std::endl;
+    CONFIG_DEBUG("addObserver") << key() << ", now " << m_observers.size() << " observers" << std::endl;
 }
 
 void Entry::removeObserver(Observer *o)
 {
+    std::lock_guard guard(m_observerMutex);
     m_observers.erase(o);
-    debug("removeObserver") << key() << ", now " << m_observers.size() << " observers" << std::endl;
+    CONFIG_DEBUG("removeObserver") << key() << ", now " << m_observers.size() << " observers" << std::endl;
 }
 
 
 template<class V>
-EntryBase<V>::EntryBase(const std::string &classname, Manager *mgr, const std::string &path, const std::string &section,
-                        const std::string &name, Flag flags)
-: Entry(classname, mgr, path, section, name, flags)
-{}
+EntryBase<V>::EntryBase(const std::string &classname, TypeTag type, Manager *mgr, const std::string &path,
+                        const std::string &section, const std::string &name, Flag flags)
+: Entry(classname, type, mgr, path, section, name, flags)
+{
+    publish();
+}
 
 template<class V>
 ValueEntry<V>::ValueEntry(Manager *mgr, const std::string &path, const std::string &section, const std::string &name,
                           Flag flags)
-: EntryBase<V>("ValueEntry", mgr, path, section, name, flags)
+: EntryBase<V>("ValueEntry", value_tag<V>(), mgr, path, section, name, flags)
 {
     const int rank = this->m_manager->rank();
+    if (rank >= 0)
+        this->materialize(sectionForRank(this->m_section, rank));
+    this->materialize(this->m_section);
+    std::shared_lock guard(this->m_config->mutex);
     if (rank >= 0) {
         std::string s = sectionForRank(this->m_section, rank);
-        this->debug() << "looking for value " << s << std::endl;
+        CONFIG_DEBUG() << "looking for value " << s << std::endl;
         auto tbl = detail::table_for_section(*this, this->m_config->config, s);
         if (auto opt = Convert<V>::get_from_table(this, tbl, this->m_name)) {
             this->m_exists = true;
             this->m_section = s;
             this->m_value = *opt;
+            this->publish();
             return;
         }
     }
-    this->debug() << "searching in " << this->m_section << "." << this->m_name << std::endl;
+    CONFIG_DEBUG() << "searching in " << this->m_section << "." << this->m_name << std::endl;
     auto tbl = detail::table_for_section(*this, this->m_config->config, this->m_section);
     if (auto opt = Convert<V>::get_from_table(this, tbl, this->m_name)) {
         //debug() << m_config->config << std::endl;
         this->m_exists = true;
         this->m_value = *opt;
-        this->debug() << "FOUND " << this->m_section << "." << this->m_name << ": value=" << this->m_value << std::endl;
+        this->publish();
+        CONFIG_DEBUG() << "FOUND " << this->m_section << "." << this->m_name << ": value=" << this->m_value
+                       << std::endl;
         return;
     }
 }
@@ -184,14 +222,25 @@ template<class V>
 V ValueEntry<V>::overrideDefaultValue(const V &value, bool &valid)
 {
     valid = false;
+    if (auto def = find_compiled_default(this->m_path, this->m_section, this->m_name)) {
+        if (auto v = compiled_value<V>(def->value)) {
+            valid = true;
+            return *v;
+        }
+        this->warn() << this->key() << ": compiled default not convertible to requested type" << std::endl;
+        return value;
+    }
+    this->m_manager->loadDefaultOverrides(*this->m_config);
+    std::shared_lock guard(this->m_config->mutex);
     auto tbl = detail::table_for_section(*this, this->m_config->defaultOverrides, this->m_section);
-    if (tbl)
-        this->debug("overrideDefaultValue")
+    if (tbl) {
+        CONFIG_DEBUG("overrideDefaultValue")
             << "searching in " << *tbl << " for " << this->m_section << "." << this->m_name << std::endl;
-    else
-        this->debug("overrideDefaultValue") << "searching in "
-                                            << "(nil)"
-                                            << " for " << this->m_section << "." << this->m_name << std::endl;
+    } else {
+        CONFIG_DEBUG("overrideDefaultValue") << "searching in "
+                                             << "(nil)"
+                                             << " for " << this->m_section << "." << this->m_name << std::endl;
+    }
     if (auto opt = Convert<V>::get_from_table(this, tbl, this->m_name, true)) {
         valid = true;
         return *opt;
@@ -217,6 +266,18 @@ const V &EntryBase<V>::value() const
     return m_value;
 }
 
+template<class V>
+V EntryBase<V>::snapshot() const
+{
+    return m_snapshot.load();
+}
+
+template<class V>
+void EntryBase<V>::publish()
+{
+    m_snapshot.store(m_value);
+}
+
 template<class V>
 const V &EntryBase<V>::defaultValue() const
 {
@@ -235,7 +296,7 @@ bool EntryBase<V>::checkDefaultValue()
     bool overrideValid = false;
     auto val = overrideDefaultValue(V(), overrideValid);
     if (overrideValid) {
-        debug("checkDefaultValue") << key() << ": overridden default value: " << val << std::endl;
+        CONFIG_DEBUG("checkDefaultValue") << key() << ": overridden default value: " << val << std::endl;
         return setOrCheckDefaultValue(V());
     }
     return false;
@@ -247,12 +308,12 @@ bool EntryBase<V>::setOrCheckDefaultValue(const V &value)
     bool overrideValid = false;
     auto val = overrideDefaultValue(value, overrideValid);
     if (overrideValid) {
-        debug("setOrCheckDefaultValue") << key() << ": overridden default value: " << val << std::endl;
+        CONFIG_DEBUG("setOrCheckDefaultValue") << key() << ": overridden default value: " << val << std::endl;
     }
     if (!m_defaultValueValid) {
         m_defaultValue = val;
         m_defaultValueValid = true;
-        debug("setOrCheckDefaultValue") << key() << ": default: " << defaultValue() << std::endl;
+        CONFIG_DEBUG("setOrCheckDefaultValue") << key() << ": default: " << defaultValue() << std::endl;
     } else if (val != m_defaultValue) {
         error("setOrCheckDefaultValue") << "differing default values for " << key() << ": " << defaultValue()
                                         << " is registered, request is " << val << std::endl;
@@ -261,9 +322,10 @@ bool EntryBase<V>::setOrCheckDefaultValue(const V &value)
     }
 
     if (!exists()) {
-        debug("setOrCheckDefaultValue") << key() << " does not exist, updating initial value from " << this->value()
-                                        << " to " << val << std::endl;
+        CONFIG_DEBUG("setOrCheckDefaultValue")
+            << key() << " does not exist, updating initial value from " << this->value() << " to " << val << std::endl;
         m_value = val;
+        publish();
     }
 
     return true;
@@ -287,36 +349,46 @@ void ValueEntry<V>::assign()
     if (this->m_flags == Flag::PerModel) {
         Value<V> val(this);
         if (this->m_manager->sendToWorkspace(&val)) {
-            this->debug("assign") << this->key() << " sent to workspace" << std::endl;
+            CONFIG_DEBUG("assign") << this->key() << " sent to workspace" << std::endl;
         } else {
             this->warn("assign") << "could not send " << this->key() << " to workspace" << std::endl;
         }
         return;
     }
 
+    this->materialize(this->m_section);
+    std::lock_guard guard(this->m_config->mutex);
     auto tbl = detail::table_for_section(*this, this->m_config->config, this->m_section, true);
     if (!tbl) {
         this->error("assign") << "name=" << this->m_name << ", could not insert parent table for section "
                               << this->m_section << " at " << this->m_path << std::endl;
         return;
     }
+    bool changed = false;
     if (this->m_defaultValueValid && this->m_value == this->m_defaultValue) {
-        tbl->erase(this->m_name);
-        this->debug("assign") << this->key() << ", " << this->m_value << " is default, erased from toml" << std::endl;
+        changed = this->m_config->config.erase(*tbl, this->m_section, this->m_name);
+        CONFIG_DEBUG("assign") << this->key() << ", " << this->m_value << " is default, erased from toml" << std::endl;
     } else {
-        tbl->insert_or_assign(this->m_name, Convert<V>::to_toml(this, this->m_value));
-        this->debug("assign") << this->key() << " inserted/assigned " << this->m_value << " to toml" << std::endl;
+        changed = this->m_config->config.update(*tbl, this->m_section, this->m_name,
+                                                 Convert<V>::to_toml(this, this->m_value));
+        CONFIG_DEBUG("assign") << this->key() << " inserted/assigned " << this->m_value << " to toml" << std::endl;
     }
-    this->m_config->modified = true;
+    // registering a value assigns it as well, this should not require saving
+    if (changed)
+        this->m_config->modified = true;
 }
 
 template<class V>
 ArrayEntry<V>::ArrayEntry(Manager *mgr, const std::string &path, const std::string &section, const std::string &name,
                           Flag flags)
-: EntryBase<std::vector<typename ArrayEntry<V>::Type>>("ArrayEntry", mgr, path, section, name, flags)
+: EntryBase<std::vector<typename ArrayEntry<V>::Type>>("ArrayEntry", array_tag<V>(), mgr, path, section, name, flags)
 {
-    const toml::array *array = nullptr;
     const int rank = this->m_manager->rank();
+    if (rank >= 0)
+        this->materialize(sectionForRank(section, rank));
+    this->materialize(section);
+    std::shared_lock guard(this->m_config->mutex);
+    const toml::array *array = nullptr;
     if (rank >= 0) {
         std::string s = sectionForRank(section, rank);
         if (auto tbl = detail::table_for_section(*this, this->m_config->config, s)) {
@@ -348,6 +420,7 @@ ArrayEntry<V>::ArrayEntry(Manager *mgr, const std::string &path, const std::stri
         ++idx;
     }
     this->m_exists = true;
+    this->publish();
 }
 
 template<class V>
@@ -355,6 +428,23 @@ typename ArrayEntry<V>::ArrayType ArrayEntry<V>::overrideDefaultValue(const type
                                                                       bool &valid)
 {
     valid = false;
+    if (auto def = find_compiled_default(this->m_path, this->m_section, this->m_name)) {
+        typename ArrayEntry<V>::ArrayType result;
+        valid = def->value.type == TypeTag::Array;
+        for (size_t idx = 0; valid && idx < def->count; ++idx) {
+            auto vopt = compiled_value<V>(def->elements[idx]);
+            if (vopt)
+                result.push_back(*vopt);
+            else
+                valid = false;
+        }
+        if (valid)
+            return result;
+        this->warn() << this->key() << ": compiled default not convertible to requested type" << std::endl;
+        return value;
+    }
+    this->m_manager->loadDefaultOverrides(*this->m_config);
+    std::shared_lock guard(this->m_config->mutex);
     auto tbl = detail::table_for_section(*this, this->m_config->defaultOverrides, this->m_section);
     if (!tbl) {
         return value;
@@ -401,6 +491,7 @@ void ArrayEntry<V>::assign()
         return;
     }
 
+    this->materialize(this->m_section);
     std::lock_guard guard(this->m_config->mutex);
     auto tbl = detail::table_for_section(*this, this->m_config->config, this->m_section, true);
     if (!tbl) {
@@ -408,18 +499,20 @@ void ArrayEntry<V>::assign()
                               << this->m_section << " at " << this->m_path << std::endl;
         return;
     }
+    bool changed = false;
     if (this->m_defaultValueValid && this->m_value == this->m_defaultValue) {
-        tbl->erase(this->m_name);
-        this->debug("assign") << this->key() << ", " << this->m_value << " is default, erased from toml" << std::endl;
+        changed = this->m_config->config.erase(*tbl, this->m_section, this->m_name);
+        CONFIG_DEBUG("assign") << this->key() << ", " << this->m_value << " is default, erased from toml" << std::endl;
     } else {
         toml::array array;
         for (auto &v: this->m_value) {
             array.push_back(Convert<V>::to_toml(this, v));
         }
-        tbl->insert_or_assign(this->m_name, array);
-        this->debug("assign") << this->key() << " inserted/assigned " << this->m_value << " to toml" << std::endl;
+        changed = this->m_config->config.update(*tbl, this->m_section, this->m_name, std::move(array));
+        CONFIG_DEBUG("assign") << this->key() << " inserted/assigned " << this->m_value << " to toml" << std::endl;
     }
-    this->m_config->modified = true;
+    if (changed)
+        this->m_config->modified = true;
 }
 
 template<class V>
@@ -434,6 +527,7 @@ void ArrayEntry<V>::resize(size_t size, const V &value)
     if (this->m_value.size() != size) {
         this->m_value.resize(size, value);
         this->setModified();
+        this->publish();
     }
 }
 
@@ -449,6 +543,22 @@ const typename ArrayEntry<V>::Type &ArrayEntry<V>::at(size_t index) const
     return this->m_value.at(index);
 }
 
+template<class V>
+size_t ArrayEntry<V>::snapshotSize() const
+{
+    auto values = this->m_snapshot.pointer();
+    return values ? values->size() : 0;
+}
+
+template<class V>
+typename ArrayEntry<V>::Type ArrayEntry<V>::snapshotAt(size_t index) const
+{
+    auto values = this->m_snapshot.pointer();
+    if (!values)
+        throw std::out_of_range("ArrayEntry::snapshotAt: nothing published");
+    return values->at(index);
+}
+
 template class EntryBase<bool>;
 template class EntryBase<int64_t>;
 template class EntryBase<double>;
@@ -8,11 +8,14 @@
 #include "observer.h"
 #include "flags.h"
 #include "logger.h"
+#include "snapshot.h"
+#include "typetag.h"
 #include "../section.h"
 
 #include <string>
 #include <set>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #ifdef CONFIG_NAMESPACE
@@ -44,9 +47,11 @@ template<class V>
 class ValueEntry;
 
 class Entry: public Logger {
+    friend class Manager;
+
 public:
-    Entry(const std::string &classname, Manager *mgr, const std::string &path, const std::string &section,
-          const std::string &name, Flag flags);
+    Entry(const std::string &classname, TypeTag type, Manager *mgr, const std::string &path,
+          const std::string &section, const std::string &name, Flag flags);
     virtual ~Entry();
     virtual bool hasDefaultValue() const = 0;
     bool exists() const;
@@ -56,25 +61,35 @@ public:
     const std::string &name() const;
     const std::string fullname() const;
     std::string key() const;
+    uint32_t handle() const; ///< index into dense entry table of Manager
+    Manager *manager() const;
+    const std::shared_ptr<Config> &config() const; ///< storage of configuration file containing entry
+    TypeTag type() const { return m_type; } ///< type of stored data, for checking before static_cast
 
     void addObserver(Observer *o);
     void removeObserver(Observer *o);
     void setModified();
     void store();
+    virtual void publish() = 0; ///< make current value available to concurrent readers
 
     Flag flags() const;
 
     virtual std::unique_ptr<ConfigBase> create() = 0;
 
 protected:
+    void materialize(const std::string &section); ///< parse deferred tables of configuration file for section
+
     Manager *m_manager = nullptr;
+    const TypeTag m_type = TypeTag::Invalid;
     bool m_modified = false;
     bool m_exists = false;
     const std::string m_path;
     std::string m_section;
     std::string m_name;
     Flag m_flags = Flag::Default;
+    uint32_t m_handle = ~uint32_t(0);
     std::shared_ptr<Config> m_config;
+    std::recursive_mutex m_observerMutex; // held while notifying, observers may register further ones
     std::set<Observer *> m_observers;
 };
 
@@ -85,11 +100,12 @@ class EntryBase: public Entry {
     friend class ValueEntry<V>;
 
 public:
-    EntryBase(const std::string &classname, Manager *mgr, const std::string &path, const std::string &section,
-              const std::string &name, Flag flags);
+    EntryBase(const std::string &classname, TypeTag type, Manager *mgr, const std::string &path,
+              const std::string &section, const std::string &name, Flag flags);
     EntryBase &operator=(const V &value);
 
     const V &value() const;
+    V snapshot() const; ///< last published value, safe to call while another thread assigns
     const V &defaultValue() const;
     bool checkDefaultValue();
     bool setOrCheckDefaultValue(const V &value);
@@ -97,10 +113,12 @@ public:
 
 protected:
     virtual V overrideDefaultValue(const V &value, bool &valid) = 0;
+    void publish() override;
 
     V m_value = V();
     bool m_defaultValueValid = false;
     V m_defaultValue = V();
+    Snapshot<V> m_snapshot;
 };
 
 template<class V>
@@ -141,6 +159,8 @@ public:
     void resize(size_t size, const V &value = V());
     Type &at(size_t index);
     const Type &at(size_t index) const;
+    size_t snapshotSize() const; ///< number of published values, safe to call while another thread assigns
+    Type snapshotAt(size_t index) const; ///< published value, safe to call while another thread assigns
 };
 
 extern template class ValueEntry<bool>;
@@ -0,0 +1,39 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file hash.h
+/// hashing of configuration keys, usable at compile time
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+/// 64 bit FNV-1a hash of `s`, continuing from `hash`
+constexpr uint64_t fnv1a(std::string_view s, uint64_t hash = 14695981039346656037ull)
+{
+    for (size_t i = 0; i < s.size(); ++i) {
+        hash ^= static_cast<unsigned char>(s[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/// hash of a configuration entry identified by path, section and name
+constexpr uint64_t hash_key(std::string_view path, std::string_view section, std::string_view name)
+{
+    // separate components by a character that may not occur within them
+    return fnv1a(name, fnv1a(":", fnv1a(section, fnv1a(":", fnv1a(path)))));
+}
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
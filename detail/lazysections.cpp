@@ -0,0 +1,292 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "lazysections.h"
+#include "mappedfile.h"
+
+#include <algorithm>
+#include <cctype>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+namespace {
+
+// first key of a table header like `[a.b]` or `[[a]]`, only where it can be matched against section names
+bool top_level_key(std::string_view header, std::string &key)
+{
+    size_t i = 0;
+    while (i < header.size() && header[i] == '[')
+        ++i;
+    while (i < header.size() && (header[i] == ' ' || header[i] == '\t'))
+        ++i;
+    if (i >= header.size())
+        return false;
+
+    const char quote = header[i];
+    if (quote == '"' || quote == '\'') {
+        auto end = header.find(quote, i + 1);
+        if (end == std::string_view::npos)
+            return false;
+        key = header.substr(i + 1, end - i - 1);
+        // keys requiring unescaping or not addressable as section names are not supported
+        if (quote == '"' && key.find('\\') != std::string::npos)
+            return false;
+        return !key.empty() && key.find_first_of(".[") == std::string::npos;
+    }
+
+    size_t end = i;
+    while (end < header.size() &&
+           (std::isalnum(static_cast<unsigned char>(header[end])) || header[end] == '_' || header[end] == '-'))
+        ++end;
+    key = header.substr(i, end - i);
+    return !key.empty();
+}
+
+// top-level key of a dotted section name, possibly indexing into an array
+std::string top_level_section(const std::string &section)
+{
+    return section.substr(0, section.find_first_of(".["));
+}
+
+} // namespace
+
+bool LazySections::scan(std::shared_ptr<const MappedFile> file)
+{
+    const std::string_view s = file->data();
+
+    enum State { Normal, Comment, Basic, Literal, MultiBasic, MultiLiteral };
+    State state = Normal;
+    int depth = 0; // nesting of arrays and inline tables within values
+    bool lineStart = true;
+    size_t lineBegin = 0, line = 0;
+
+    std::map<std::string, std::vector<Range>> ranges;
+    std::vector<Range> *current = nullptr;
+    size_t preambleEnd = s.size();
+    std::vector<std::string> preambleKeys; // top-level keys assigned before the first table, e.g. `a` of `a.b = 1`
+
+    for (size_t i = 0; i < s.size(); ++i) {
+        const char c = s[i];
+        if (c == '\n') {
+            if (state == Basic || state == Literal)
+                return false;
+            if (state == Comment)
+                state = Normal;
+            ++line;
+            lineBegin = i + 1;
+            lineStart = true;
+            continue;
+        }
+
+        switch (state) {
+        case Comment:
+            continue;
+        case Basic:
+            if (c == '\\')
+                ++i;
+            else if (c == '"')
+                state = Normal;
+            continue;
+        case Literal:
+            if (c == '\'')
+                state = Normal;
+            continue;
+        case MultiBasic:
+            if (c == '\\' && i + 1 < s.size() && s[i + 1] != '\n') {
+                ++i;
+            } else if (s.compare(i, 3, "\"\"\"") == 0) {
+                i += 2;
+                while (i + 1 < s.size() && s[i + 1] == '"')
+                    ++i;
+                state = Normal;
+            }
+            continue;
+        case MultiLiteral:
+            if (s.compare(i, 3, "'''") == 0) {
+                i += 2;
+                while (i + 1 < s.size() && s[i + 1] == '\'')
+                    ++i;
+                state = Normal;
+            }
+            continue;
+        case Normal:
+            break;
+        }
+
+        if (c == ' ' || c == '\t' || c == '\r')
+            continue;
+        const bool first = lineStart;
+        lineStart = false;
+
+        if (c == '#') {
+            state = Comment;
+        } else if (first && depth == 0 && c == '[') {
+            auto end = s.find('\n', i);
+            if (end == std::string_view::npos)
+                end = s.size();
+            std::string key;
+            if (!top_level_key(s.substr(i, end - i), key))
+                return false;
+            if (current)
+                current->back().end = lineBegin;
+            else
+                preambleEnd = lineBegin;
+            current = &ranges[key];
+            current->push_back(Range{lineBegin, s.size(), line});
+            // continue with newline ending header, comments on header line are skipped
+            i = end - 1;
+        } else if (first && depth == 0 && !current) {
+            auto end = s.find_first_of("=\n", i);
+            if (end == std::string_view::npos)
+                end = s.size();
+            std::string key;
+            if (!top_level_key(s.substr(i, end - i), key))
+                return false;
+            preambleKeys.push_back(key);
+            // scan key again, as it might be quoted
+            --i;
+        } else if (c == '"') {
+            if (s.compare(i, 3, "\"\"\"") == 0) {
+                state = MultiBasic;
+                i += 2;
+            } else {
+                state = Basic;
+            }
+        } else if (c == '\'') {
+            if (s.compare(i, 3, "'''") == 0) {
+                state = MultiLiteral;
+                i += 2;
+            } else {
+                state = Literal;
+            }
+        } else if (c == '[' || c == '{') {
+            ++depth;
+        } else if ((c == ']' || c == '}') && depth > 0) {
+            --depth;
+        }
+    }
+    if ((state != Normal && state != Comment) || depth != 0)
+        return false;
+
+    // tables extending those defined by dotted keys have to be parsed together with them
+    std::vector<Range> eager{Range{0, preambleEnd, 0}};
+    for (const auto &key: preambleKeys) {
+        auto it = ranges.find(key);
+        if (it == ranges.end())
+            continue;
+        eager.insert(eager.end(), it->second.begin(), it->second.end());
+        ranges.erase(it);
+    }
+    std::sort(eager.begin(), eager.end(), [](const Range &a, const Range &b) { return a.begin < b.begin; });
+
+    std::lock_guard guard(m_mutex);
+    m_file = std::move(file);
+    m_preamble = text(eager);
+    m_ranges = std::move(ranges);
+    update();
+    return true;
+}
+
+const std::string &LazySections::preamble() const
+{
+    return m_preamble;
+}
+
+bool LazySections::pending() const
+{
+    return m_pending;
+}
+
+std::string LazySections::take(const std::string &section)
+{
+    std::lock_guard guard(m_mutex);
+    if (!m_file)
+        return std::string();
+
+    std::vector<Range> ranges;
+    if (section.empty()) {
+        for (auto &r: m_ranges)
+            ranges.insert(ranges.end(), r.second.begin(), r.second.end());
+        std::sort(ranges.begin(), ranges.end(), [](const Range &a, const Range &b) { return a.begin < b.begin; });
+        m_ranges.clear();
+    } else {
+        auto it = m_ranges.find(top_level_section(section));
+        if (it == m_ranges.end())
+            return std::string();
+        ranges = std::move(it->second);
+        m_ranges.erase(it);
+    }
+
+    auto result = text(ranges);
+    update();
+    return result;
+}
+
+void LazySections::include(Include inc)
+{
+    std::lock_guard guard(m_mutex);
+    auto section = inc.section;
+    m_includes[section] = std::move(inc);
+    update();
+}
+
+std::vector<LazySections::Include> LazySections::takeIncludes(const std::string &section)
+{
+    std::lock_guard guard(m_mutex);
+    std::vector<Include> includes;
+    if (section.empty()) {
+        for (auto &inc: m_includes)
+            includes.emplace_back(std::move(inc.second));
+        m_includes.clear();
+    } else {
+        auto it = m_includes.find(top_level_section(section));
+        if (it == m_includes.end())
+            return includes;
+        includes.emplace_back(std::move(it->second));
+        m_includes.erase(it);
+    }
+    update();
+    return includes;
+}
+
+void LazySections::clear()
+{
+    std::lock_guard guard(m_mutex);
+    m_preamble.clear();
+    m_ranges.clear();
+    m_includes.clear();
+    update();
+}
+
+std::string LazySections::text(const std::vector<Range> &ranges) const
+{
+    // pad with empty lines, so that parse errors refer to lines within the file
+    const std::string_view s = m_file->data();
+    std::string text;
+    size_t line = 0;
+    for (const auto &r: ranges) {
+        text.append(r.line - line, '\n');
+        auto part = s.substr(r.begin, r.end - r.begin);
+        text.append(part);
+        line = r.line + std::count(part.begin(), part.end(), '\n');
+    }
+    return text;
+}
+
+void LazySections::update()
+{
+    if (m_ranges.empty())
+        m_file.reset();
+    m_pending = !m_ranges.empty() || !m_includes.empty();
+}
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
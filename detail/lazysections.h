@@ -0,0 +1,73 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file lazysections.h
+/// deferred parsing of the top-level tables of large configuration files
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+class MappedFile;
+
+/// byte ranges of top-level tables within a configuration file that have not been parsed yet
+/** A single scan records where the tables of each top-level key are defined,
+    their text is handed out for parsing once a section within them is accessed.
+    Key/value pairs before the first table are parsed immediately,
+    together with tables extending keys defined there, as with `a.b = 1` followed by `[a.c]`.
+    Also keeps track of fragments included from other files, which are loaded on first access as well. */
+class LazySections {
+public:
+    static constexpr size_t Threshold = 256 * 1024; ///< only files at least this large are parsed lazily
+
+    /// top-level table provided by another configuration file
+    struct Include {
+        std::string section; ///< top-level key of including file
+        std::string path; ///< configuration path of fragment
+        std::vector<std::string> searchPath; ///< for locating fragment
+        std::string userPath; ///< for locating fragment
+    };
+
+    bool scan(std::shared_ptr<const MappedFile> file); ///< returns false if file cannot be split reliably
+    const std::string &preamble() const; ///< text to be parsed immediately
+    bool pending() const; ///< whether any tables are still unparsed
+    std::string take(const std::string &section); ///< remove and return text of tables for section, all if empty
+    void include(Include inc); ///< defer loading of a fragment
+    std::vector<Include> takeIncludes(const std::string &section); ///< remove fragments for section, all if empty
+    void clear();
+
+private:
+    struct Range {
+        size_t begin = 0;
+        size_t end = 0;
+        size_t line = 0; ///< number of lines preceding begin, for keeping line numbers in error messages
+    };
+
+    std::mutex m_mutex;
+    std::atomic<bool> m_pending{false};
+    std::shared_ptr<const MappedFile> m_file;
+    std::string m_preamble; // key/value pairs before first table and tables extending them
+    std::map<std::string, std::vector<Range>> m_ranges; // by top-level key
+    std::map<std::string, Include> m_includes; // by top-level key
+
+    std::string text(const std::vector<Range> &ranges) const; ///< requires m_file
+    void update(); ///< requires m_mutex to be held
+};
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
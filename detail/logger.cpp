@@ -36,74 +36,77 @@ private:
 } // namespace
 
 
-Logger::Logger(const std::string &classname): m_name(std::string(CONFIG_NAME) + "::config::" + classname)
+Logger::Logger(const std::string &classname): m_name(classname)
 {}
 
 Logger::~Logger() = default;
 
 std::string Logger::prefix(const std::string &func) const
 {
+    std::string p = std::string(CONFIG_NAME) + "::config::" + m_name;
     if (func.empty())
-        return m_name + ": ";
-    return m_name + "::" + func + ": ";
+        return p + ": ";
+    return p + "::" + func + ": ";
 }
 
-std::ostream &Logger::getStream(int level) const
+int Logger::level()
 {
-    static NullStream null;
-    static int logLevel = -1;
-
-    if (logLevel < 0) {
+    static const int logLevel = []() {
+        int level = Info;
         if (const char *envLevel = getenv("COVCONFIG_DEBUG")) {
             if (envLevel[0] == '\0') {
-                logLevel = All;
+                level = All;
             } else if (std::string(CONFIG_NAME) == envLevel) {
-                logLevel = All;
+                level = All;
             } else {
                 try {
-                    logLevel = std::stoi(envLevel);
+                    level = std::stoi(envLevel);
                 } catch (...) {
-                    logLevel = -1;
+                    level = -1;
                 }
-                if (logLevel < 0)
-                    logLevel = Info;
+                if (level < 0)
+                    level = Info;
             }
-        } else {
-            logLevel = Info;
         }
-    }
-    if (level > logLevel) {
+        return level;
+    }();
+    return logLevel;
+}
+
+bool Logger::isDebugEnabled() const
+{
+    return level() >= Debug;
+}
+
+std::ostream &Logger::getStream(int level, const char *tag, const std::string &func) const
+{
+    static NullStream null;
+
+    if (level > Logger::level()) {
         return null;
     }
+    std::cerr << tag << prefix(func);
     return std::cerr;
 }
 
 std::ostream &Logger::debug(const std::string &func) const
 {
-    auto &str = getStream(Debug);
-    str << "Debug: " << prefix(func);
-    return str;
+    return getStream(Debug, "Debug: ", func);
 }
 
 std::ostream &Logger::info(const std::string &func) const
 {
-    auto &str = getStream(Info);
-    str << "Info: " << prefix(func);
-    return str;
+    return getStream(Info, "Info: ", func);
 }
 
 std::ostream &Logger::warn(const std::string &func) const
 {
-    auto &str = getStream(Warn);
-    str << "Warn: " << prefix(func);
-    return str;
+    return getStream(Warn, "Warn: ", func);
 }
 
 std::ostream &Logger::error(const std::string &func) const
 {
-    auto &str = getStream(Error);
-    str << "ERROR: " << prefix(func);
-    return str;
+    return getStream(Error, "ERROR: ", func);
 }
 
 } // namespace detail
@@ -19,6 +19,22 @@
 #endif
 #endif
 
+/// stream debug output via `logger`, evaluating the streamed arguments only if debug output is enabled
+/** Define CONFIG_NO_DEBUG to remove all debug output at compile time. */
+#ifdef CONFIG_NO_DEBUG
+#define CONFIG_DEBUG_FOR(logger, ...) \
+    if (true) { \
+    } else \
+        (logger).debug(__VA_ARGS__)
+#else
+#define CONFIG_DEBUG_FOR(logger, ...) \
+    if (!(logger).isDebugEnabled()) { \
+    } else \
+        (logger).debug(__VA_ARGS__)
+#endif
+/// stream debug output of the current object, see \ref CONFIG_DEBUG_FOR
+#define CONFIG_DEBUG(...) CONFIG_DEBUG_FOR(*this, __VA_ARGS__)
+
 #ifdef CONFIG_NAMESPACE
 namespace CONFIG_NAMESPACE {
 #endif
@@ -34,14 +50,16 @@ public:
     virtual ~Logger();
 
 public:
+    bool isDebugEnabled() const; ///< whether output to debug() is shown, use via CONFIG_DEBUG
     std::ostream &debug(const std::string &func = std::string()) const;
     std::ostream &info(const std::string &func = std::string()) const;
     std::ostream &warn(const std::string &func = std::string()) const;
     std::ostream &error(const std::string &func = std::string()) const;
 
 private:
+    static int level();
     std::string prefix(const std::string &func) const;
-    std::ostream &getStream(int level) const;
+    std::ostream &getStream(int level, const char *tag, const std::string &func) const;
 
     std::string m_name;
 };
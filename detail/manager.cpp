@@ -5,8 +5,12 @@
 #include "../array.h"
 #include "../access.h"
 #include "../file.h"
+#include "../collective.h"
 #include "manager.h"
 #include "entry.h"
+#include "mappedfile.h"
+#include "lazysections.h"
+#include "retention.h"
 
 #include "manager_impl.h"
 
@@ -14,10 +18,17 @@
 
 #include <iostream>
 #include <cstdio>
+#include <cstring>
 #include <cassert>
 #include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <string_view>
 #include <algorithm>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <system_error>
 #ifdef _WIN32
 #include <windows.h>
 #include <direct.h>
@@ -29,7 +40,6 @@
 
 #ifdef CONFIG_CMRC_NAMESPACE
 #include <cmrc/cmrc.hpp>
-#include <sstream>
 
 CMRC_DECLARE(CONFIG_CMRC_NAMESPACE);
 #endif
@@ -42,6 +52,11 @@ namespace config {
 namespace detail {
 
 static Manager *instance = nullptr;
+static std::atomic<uint32_t> generations{0}; // number of instances created
+static std::atomic<size_t> helpers{0}; // worker threads started by all running calls to runJobs
+
+static const char IncludeKey[] = "@include"; // reserved top-level key mapping sections to configuration paths
+static const int MaxIncludeDepth = 8; // guards against cyclic includes
 
 const std::string &sep()
 {
@@ -68,7 +83,7 @@ bool Manager::exists()
 
 
 Manager::Manager(const std::string &host, const std::string &cluster, int rank)
-: Logger("Manager"), m_hostname(host), m_cluster(cluster), m_rank(rank)
+: Logger("Manager"), m_hostname(host), m_cluster(cluster), m_rank(rank), m_generation(++generations)
 {
     setErrorHandler([this]() {
         if (!getenv("COVCONFIG_IGNORE_ERRORS")) {
@@ -77,19 +92,24 @@ Manager::Manager(const std::string &host, const std::string &cluster, int rank)
         }
     });
     if (instance) {
-        debug() << "host=" << host << ", cluster=" << cluster << ", rank=" << rank
-                << ", not overwriting existing instance" << std::endl;
+        CONFIG_DEBUG() << "host=" << host << ", cluster=" << cluster << ", rank=" << rank
+                       << ", not overwriting existing instance" << std::endl;
     } else {
         instance = this;
-        debug() << "host=" << host << ", cluster=" << cluster << ", rank=" << rank << ", NEW INSTANCE" << std::endl;
+        CONFIG_DEBUG() << "host=" << host << ", cluster=" << cluster << ", rank=" << rank << ", NEW INSTANCE"
+                       << std::endl;
     }
     if (auto host = getenv("COVCONFIG_HOST")) {
         m_hostname = host;
-        debug() << "overriding host from environment to=" << host << std::endl;
+        CONFIG_DEBUG() << "overriding host from environment to=" << host << std::endl;
     }
     if (auto cluster = getenv("COVCONFIG_CLUSTER")) {
         m_cluster = cluster;
-        debug() << "overriding cluster from environment to=" << cluster << std::endl;
+        CONFIG_DEBUG() << "overriding cluster from environment to=" << cluster << std::endl;
+    }
+    if (getenv("COVCONFIG_LAZY")) {
+        m_lazy = true;
+        CONFIG_DEBUG() << "parsing tables of large files on first access" << std::endl;
     }
     reconfigure();
 }
@@ -124,11 +144,11 @@ void Manager::sendAllEntries()
 {
     if (!m_bridge)
         return;
-    std::lock_guard guard(m_mutex);
-    for (const auto &e: m_entries) {
-        if (e.second->flags() != Flag::PerModel)
+    for (uint32_t h = 0; h < m_table.size(); ++h) {
+        auto e = m_table.get(h);
+        if (e->flags() != Flag::PerModel)
             continue;
-        auto cb = e.second->create();
+        auto cb = e->create();
         sendToWorkspace(cb.get());
     }
 }
@@ -141,9 +161,10 @@ void Manager::reconfigure()
     const std::string cfg = "covconfig";
 #endif
 
+    std::vector<std::string> searchPath;
     if (auto configname = getenv("COVCONFIG")) {
-        m_path.push_back(configname);
-        debug() << "setting first search path from COVCONFIG environment to " << configname << std::endl;
+        searchPath.push_back(configname);
+        CONFIG_DEBUG() << "setting first search path from COVCONFIG environment to " << configname << std::endl;
     }
 
     // current directory
@@ -153,26 +174,27 @@ void Manager::reconfigure()
 #else
     if (const char *wd = getcwd(cwd.data(), cwd.size())) {
 #endif
-        m_path.push_back(wd + sep() + "." + cfg);
+        searchPath.push_back(wd + sep() + "." + cfg);
     } else {
         error() << "cannot obtain current directory: " << strerror(errno) << std::endl;
     }
     // writable user config directory
+    std::string userPath;
     if (const char *xdg_ch = getenv("XDG_CONFIG_HOME")) {
-        m_userPath = xdg_ch + sep() + cfg;
+        userPath = xdg_ch + sep() + cfg;
     } else if (const char *home = getenv("HOME")) {
-        m_userPath = home + sep() + ".config" + sep() + cfg;
+        userPath = home + sep() + ".config" + sep() + cfg;
     } else if (const char *home = getenv("APPDATA")) {
-        m_userPath = home + sep() + cfg;
+        userPath = home + sep() + cfg;
     } else {
         error() << "cannot obtain HOME environment variable" << std::endl;
     }
-    if (!m_userPath.empty()) {
-        m_path.push_back(m_userPath);
+    if (!userPath.empty()) {
+        searchPath.push_back(userPath);
     }
     // software installation directory
     if (!m_installPrefix.empty()) {
-        m_path.push_back(m_installPrefix + sep() + "config");
+        searchPath.push_back(m_installPrefix + sep() + "config");
     }
     // global system configuration
     std::string dirs("/etc/xdg");
@@ -185,13 +207,43 @@ void Manager::reconfigure()
         auto end = std::find(begin, dirs.end(), ':');
         std::string dir(begin, end);
         if (!dir.empty()) {
-            m_path.push_back(dir + sep() + cfg);
+            searchPath.push_back(dir + sep() + cfg);
         }
         begin = end;
         if (begin != dirs.end()) {
             begin = begin + 1;
         }
     }
+
+    // probe each existing directory only once
+    std::vector<std::string> canonicalPath;
+    for (const auto &dir: searchPath) {
+        std::error_code ec;
+        auto canon = std::filesystem::canonical(dir, ec);
+        if (ec || !std::filesystem::is_directory(canon, ec)) {
+            CONFIG_DEBUG("reconfigure") << "dropping search directory " << dir << ": does not exist" << std::endl;
+            continue;
+        }
+        std::string c = canon.string();
+        if (std::find(canonicalPath.begin(), canonicalPath.end(), c) != canonicalPath.end()) {
+            CONFIG_DEBUG("reconfigure") << "dropping search directory " << dir << ": duplicate of " << c << std::endl;
+            continue;
+        }
+        canonicalPath.push_back(c);
+    }
+
+    // compared against base directories of loaded files, which are canonical
+    if (!userPath.empty()) {
+        std::error_code ec;
+        auto canon = std::filesystem::weakly_canonical(userPath, ec);
+        if (!ec)
+            userPath = canon.string();
+    }
+
+    std::lock_guard guard(m_mutex);
+    m_userPath = userPath;
+    m_path = std::move(canonicalPath);
+    m_dirCache.clear();
 }
 
 void Manager::acquire()
@@ -215,18 +267,23 @@ bool Manager::release()
 Manager::~Manager()
 {
     if (this == instance) {
-        debug("~") << "destroying DEFAULT INSTANCE" << std::endl;
+        CONFIG_DEBUG("~") << "destroying DEFAULT INSTANCE" << std::endl;
         instance = nullptr;
     } else {
-        debug("~") << "destroying" << std::endl;
+        CONFIG_DEBUG("~") << "destroying" << std::endl;
+    }
+
+    for (auto &f: m_background) {
+        f.wait();
     }
 
     saveAllAutosave();
 
-    for (auto &e: m_entries) {
-        delete e.second;
-    }
     m_entries.clear();
+    for (uint32_t h = 0; h < m_table.size(); ++h) {
+        delete m_table.get(h);
+    }
+    m_table.clear();
 }
 
 void Manager::setErrorHandler(std::function<void()> handler)
@@ -237,13 +294,13 @@ void Manager::setErrorHandler(std::function<void()> handler)
 void Manager::setPrefix(const std::string &dir)
 {
     m_installPrefix = dir;
-    debug("setPrefix") << "installation prefix set to " << m_installPrefix << std::endl;
+    CONFIG_DEBUG("setPrefix") << "installation prefix set to " << m_installPrefix << std::endl;
     reconfigure();
 }
 
 void Manager::setRank(int rank)
 {
-    debug("setRank") << "rank is " << m_rank << ", trying to set rank to " << rank << std::endl;
+    CONFIG_DEBUG("setRank") << "rank is " << m_rank << ", trying to set rank to " << rank << std::endl;
     if (m_rank == rank)
         return;
     if (m_rank != -1) {
@@ -269,7 +326,7 @@ const std::string &Manager::hostname() const
     return m_hostname;
 }
 
-std::shared_ptr<Config> Manager::registerPath(const std::string &path)
+std::shared_ptr<Config> Manager::claimPath(const std::string &path, std::unique_ptr<LoadJob> &job)
 {
     std::lock_guard guard(m_mutex);
     auto it = m_configs.find(path);
@@ -277,11 +334,265 @@ std::shared_ptr<Config> Manager::registerPath(const std::string &path)
         return it->second;
     }
 
-    auto &config = m_configs[path];
-    if (!config) {
-        config = std::make_shared<Config>();
+    // publish placeholder, other threads requesting the same path wait until it has been loaded
+    job = std::make_unique<LoadJob>();
+    job->config = std::make_shared<Config>();
+    job->config->loaded = job->loaded.get_future().share();
+    job->path = path;
+    job->searchPath = m_path;
+    job->userPath = m_userPath;
+    m_configs[path] = job->config;
+    return job->config;
+}
+
+void Manager::runJob(LoadJob &job)
+{
+    // file I/O and parsing without holding m_mutex
+    try {
+        if (job.received) {
+            // files specific to this host or cluster take precedence over the common file received from root
+            if (!loadConfig(*job.config, job.path, job.searchPath, job.userPath, true) && job.exists &&
+                parseConfig(*job.config, job.contents, job.base, job.path, job.pathname)) {
+                // fragments are searched for locally, as they are loaded on first access
+                registerIncludes(*job.config, job.searchPath, job.userPath);
+            }
+        } else {
+            loadConfig(*job.config, job.path, job.searchPath, job.userPath);
+        }
+    } catch (std::exception &ex) {
+        error("registerPath") << "failed to load " << job.path << ": " << ex.what() << std::endl;
+    } catch (...) {
+        // waiting threads must not block forever on an unfulfilled promise
+        error("registerPath") << "failed to load " << job.path << ": unknown exception" << std::endl;
+        job.loaded.set_exception(std::current_exception());
+        return;
     }
+    job.loaded.set_value();
+}
+
+std::shared_ptr<Config> Manager::registerPath(const std::string &path)
+{
+    std::unique_ptr<LoadJob> job;
+    auto config = claimPath(path, job);
+    if (job) {
+        runJob(*job);
+    } else {
+        // only blocks while another thread is still loading this path
+        config->loaded.wait();
+    }
+    return config;
+}
+
+void Manager::runJobs(const std::vector<std::unique_ptr<LoadJob>> &jobs)
+{
+    if (jobs.empty())
+        return;
+
+    // helper threads are budgeted across concurrent calls (e.g. from prefetch),
+    // so that including the calling threads there are not more than hardware threads
+    const size_t maxHelpers = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    const size_t wanted = std::min(maxHelpers, jobs.size() - 1);
+    size_t numHelpers = 0;
+    size_t busy = helpers.load();
+    do {
+        numHelpers = std::min(wanted, maxHelpers - std::min(busy, maxHelpers));
+    } while (numHelpers > 0 && !helpers.compare_exchange_weak(busy, busy + numHelpers));
+
+    std::atomic<size_t> next{0};
+    auto work = [this, &jobs, &next]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            runJob(*jobs[i]);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    try {
+        for (size_t i = 0; i < numHelpers; ++i) {
+            workers.emplace_back(work);
+        }
+    } catch (std::system_error &ex) {
+        CONFIG_DEBUG("runJobs") << "could not start worker thread: " << ex.what() << std::endl;
+    }
+    work();
+    for (auto &t: workers) {
+        t.join();
+    }
+    helpers -= numHelpers;
+}
+
+void Manager::load(const std::vector<std::string> &paths)
+{
+    std::vector<std::shared_ptr<Config>> configs;
+    std::vector<std::unique_ptr<LoadJob>> jobs;
+    for (const auto &path: paths) {
+        std::unique_ptr<LoadJob> job;
+        configs.emplace_back(claimPath(path, job));
+        if (job)
+            jobs.emplace_back(std::move(job));
+    }
+
+    CONFIG_DEBUG("load") << "loading " << jobs.size() << " of " << paths.size() << " paths concurrently" << std::endl;
+    runJobs(jobs);
+
+    // paths claimed by other threads might still be loading
+    for (auto &config: configs) {
+        config->loaded.wait();
+    }
+}
+
+// length prefixed strings for transmitting configuration files to other ranks
+static void put_string(std::string &buf, std::string_view s)
+{
+    const uint64_t len = s.size();
+    buf.append(reinterpret_cast<const char *>(&len), sizeof(len));
+    buf.append(s.data(), s.size());
+}
 
+static bool get_string(std::string_view &buf, std::string &s)
+{
+    uint64_t len = 0;
+    if (buf.size() < sizeof(len))
+        return false;
+    memcpy(&len, buf.data(), sizeof(len));
+    buf.remove_prefix(sizeof(len));
+    if (buf.size() < len)
+        return false;
+    s = buf.substr(0, len);
+    buf.remove_prefix(len);
+    return true;
+}
+
+void Manager::load(const std::vector<std::string> &paths, Collective &collective)
+{
+    const bool root = collective.rank() == collective.root();
+    std::string data;
+    if (root) {
+        load(paths);
+        std::vector<std::string> searchPath;
+        {
+            std::lock_guard guard(m_mutex);
+            searchPath = m_path;
+        }
+        // only files independent of host and cluster are shared, as other ranks might run on different hosts
+        for (const auto &path: paths) {
+            // files are read again, as only the parsed contents are retained
+            const std::string base = findCommon(path, searchPath);
+            const std::string pathname = base + sep() + path + ".toml";
+            MappedFile file(base.empty() ? std::string() : pathname);
+            put_string(data, path);
+            data.push_back(file.valid() ? 1 : 0);
+            if (file.valid()) {
+                put_string(data, base);
+                put_string(data, pathname);
+                put_string(data, file.data());
+            }
+        }
+    }
+
+    if (!collective.broadcast(data)) {
+        error("load") << "broadcast of configuration files failed" << std::endl;
+        handleError();
+        if (!root)
+            load(paths);
+        return;
+    }
+    if (root)
+        return;
+
+    std::vector<std::unique_ptr<LoadJob>> files;
+    std::string_view buf(data);
+    for (const auto &path: paths) {
+        auto file = std::make_unique<LoadJob>();
+        if (!get_string(buf, file->path) || file->path != path || buf.empty())
+            break;
+        file->received = true;
+        file->exists = buf[0] != 0;
+        buf.remove_prefix(1);
+        if (file->exists &&
+            (!get_string(buf, file->base) || !get_string(buf, file->pathname) || !get_string(buf, file->contents)))
+            break;
+        files.emplace_back(std::move(file));
+    }
+    if (files.size() != paths.size() || !buf.empty()) {
+        error("load") << "received invalid configuration data from rank " << collective.root() << std::endl;
+        handleError();
+        load(paths);
+        return;
+    }
+
+    std::vector<std::shared_ptr<Config>> configs;
+    std::vector<std::unique_ptr<LoadJob>> jobs;
+    for (auto &file: files) {
+        std::unique_ptr<LoadJob> job;
+        configs.emplace_back(claimPath(file->path, job));
+        if (job) {
+            job->received = true;
+            job->exists = file->exists;
+            job->base = std::move(file->base);
+            job->pathname = std::move(file->pathname);
+            job->contents = std::move(file->contents);
+            jobs.emplace_back(std::move(job));
+        }
+    }
+
+    CONFIG_DEBUG("load") << "parsing " << jobs.size() << " of " << paths.size() << " paths received from rank "
+                         << collective.root() << std::endl;
+    runJobs(jobs);
+
+    // paths claimed by other threads might still be loading
+    for (auto &config: configs) {
+        config->loaded.wait();
+    }
+}
+
+void Manager::prefetch(const std::vector<std::string> &paths)
+{
+    std::vector<std::unique_ptr<LoadJob>> jobs;
+    for (const auto &path: paths) {
+        std::unique_ptr<LoadJob> job;
+        claimPath(path, job);
+        if (job)
+            jobs.emplace_back(std::move(job));
+    }
+    if (jobs.empty())
+        return;
+
+    CONFIG_DEBUG("prefetch") << "loading " << jobs.size() << " paths in background" << std::endl;
+    auto future = std::async(std::launch::async, [this, jobs = std::move(jobs)]() { runJobs(jobs); });
+
+    std::lock_guard guard(m_mutex);
+    m_background.erase(std::remove_if(m_background.begin(), m_background.end(),
+                                      [](const std::future<void> &f) {
+                                          return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                                      }),
+                       m_background.end());
+    m_background.emplace_back(std::move(future));
+}
+
+// identifies the file found for path with a search configuration
+static std::string retention_key(const std::string &path, const std::string &userPath,
+                                 const std::vector<std::string> &infixes, const std::vector<std::string> &searchPath)
+{
+    std::string key = path + '\n' + userPath;
+    for (const auto &infix: infixes)
+        key += '\n' + infix;
+    for (const auto &dir: searchPath)
+        key += '\n' + dir;
+    return key;
+}
+
+std::string Manager::findCommon(const std::string &path, const std::vector<std::string> &searchPath)
+{
+    for (const auto &basedir: searchPath) {
+        if (m_dirCache.contains(basedir + sep() + path + ".toml"))
+            return basedir;
+    }
+    return std::string();
+}
+
+bool Manager::loadConfig(Config &config, const std::string &path, const std::vector<std::string> &searchPath,
+                         const std::string &userPath, bool specificOnly)
+{
     std::vector<std::string> infixes;
     if (!m_cluster.empty() && !m_hostname.empty()) {
         infixes.push_back(sep() + "c_" + m_cluster + sep() + "h_" + m_hostname);
@@ -292,69 +603,324 @@ std::shared_ptr<Config> Manager::registerPath(const std::string &path)
     if (!m_cluster.empty()) {
         infixes.push_back(sep() + "c_" + m_cluster);
     }
-    infixes.push_back("");
+    if (!specificOnly)
+        infixes.push_back("");
+    // candidate directories in order of precedence
+    std::vector<std::string> dirs;
+    for (const auto &infix: infixes) {
+        for (const auto &basedir: searchPath)
+            dirs.push_back(basedir + infix);
+    }
 
-    auto parse_config([&](std::istream &file, const std::string &dir, const std::string &path,
-                          const std::string &pathname, bool overrideDefaults = false) -> bool {
-        toml::table tbl;
+    // files received from another rank are not retained, as they are searched for by that rank
+    auto &retained = RetainedConfigs::the();
+    std::string key;
+    if (retained.enabled() && !searchPath.empty()) {
+        key = retention_key(path, userPath, infixes, searchPath);
+        // a file added to a directory searched earlier takes precedence
+        auto shadowed = [this, &dirs, &path](const std::string &base) {
+            for (const auto &dir: dirs) {
+                if (dir == base)
+                    return false;
+                if (m_dirCache.contains(dir + sep() + path + ".toml"))
+                    return true;
+            }
+            return false;
+        };
+        auto file = retained.find(key);
+        if (file && shadowed(file->base)) {
+            CONFIG_DEBUG("registerPath") << "not reusing retained " << file->pathname << ", shadowed by another file"
+                                         << std::endl;
+        } else if (file) {
+            CONFIG_DEBUG("registerPath") << file->pathname << " unchanged, reusing retained contents" << std::endl;
+            {
+                std::lock_guard guard(config.mutex);
+                config.path = path;
+                config.base = file->base;
+                config.config.reset(toml::table(*file->config));
+                config.snapshot.reset();
+                config.exists = true;
+            }
+            // locks config.mutex itself
+            registerIncludes(config, searchPath, userPath);
+            return true;
+        }
+    }
+
+    for (const auto &dir: dirs) {
+        std::string pathname = dir + sep() + path + ".toml";
+        if (!m_dirCache.contains(pathname)) {
+            CONFIG_DEBUG("registerPath") << pathname << " not found" << std::endl;
+            continue;
+        }
+        auto file = std::make_shared<const MappedFile>(pathname);
+        if (!file->valid()) {
+            CONFIG_DEBUG("registerPath") << pathname << " not found" << std::endl;
+            continue;
+        }
+        if (m_lazy && file->size() >= LazySections::Threshold && parseLazily(config, file, dir, path, pathname)) {
+            registerIncludes(config, searchPath, userPath);
+            return true;
+        }
+        if (parseConfig(config, file->data(), dir, path, pathname)) {
+            if (!key.empty()) {
+                // size and modification time as of reading, so that later changes are noticed
+                RetainedConfigs::File kept;
+                kept.base = dir;
+                kept.pathname = pathname;
+                kept.size = file->size();
+                kept.mtime = file->mtime();
+                std::shared_lock guard(config.mutex);
+                kept.config = std::make_shared<const toml::table>(config.config.root());
+                retained.store(key, std::move(kept));
+            }
+            registerIncludes(config, searchPath, userPath);
+            return true;
+        }
+    }
+
+    std::lock_guard guard(config.mutex);
+    config.path = path;
+    config.base = userPath;
+    return false;
+}
+
+bool Manager::parseConfig(Config &config, std::string_view contents, const std::string &dir, const std::string &path,
+                          const std::string &pathname, bool overrideDefaults)
+{
+    toml::table tbl;
+    TreeCache::Reference snapshot;
+    if (auto cached = m_treeCache.load(pathname, contents, snapshot)) {
+        tbl = std::move(*cached);
+    } else {
         try {
-            tbl = toml::parse(file, pathname);
-            debug("registerPath") << pathname << " OK" << std::endl;
+            tbl = toml::parse(contents, pathname);
+            CONFIG_DEBUG("registerPath") << pathname << " OK" << std::endl;
         } catch (toml::parse_error &ex) {
             error("registerPath") << ex << std::endl;
             handleError();
             return false;
         } catch (std::exception &ex) {
-            info("registerPath") << "unhandled exception while parsing " << pathname << ": " << ex.what() << std::endl;
+            info("registerPath") << "unhandled exception while parsing " << pathname << ": " << ex.what()
+                                 << std::endl;
             return false;
         }
-        auto config = m_configs[path];
-        assert(config);
-        if (overrideDefaults) {
-            config->defaultOverrides = tbl;
-            debug("registerPath") << pathname << " loaded as fallback overrides" << std::endl;
-        } else {
-            config->path = path;
-            config->base = dir;
-            config->config = tbl;
-            config->exists = true;
+        m_treeCache.store(pathname, contents, tbl, snapshot);
+    }
+    std::lock_guard guard(config.mutex);
+    if (overrideDefaults) {
+        config.defaultOverrides.reset(std::move(tbl));
+        CONFIG_DEBUG("registerPath") << pathname << " loaded as fallback overrides" << std::endl;
+    } else {
+        config.path = path;
+        config.base = dir;
+        config.config.reset(std::move(tbl));
+        config.snapshot = std::move(snapshot);
+        config.exists = true;
+    }
+    return true;
+}
+
+void Manager::loadDefaultOverrides(Config &config)
+{
+    std::call_once(config.overridesLoaded, [this, &config]() {
+#ifdef CONFIG_CMRC_NAMESPACE
+        std::string path;
+        {
+            std::shared_lock guard(config.mutex);
+            path = config.path;
         }
-        return true;
+        std::string pathname = path + ".toml";
+        try {
+            std::string dir;
+
+            auto fs = cmrc::CONFIG_CMRC_NAMESPACE::get_filesystem();
+            auto data = fs.open(pathname);
+            pathname = "CMRC:" + pathname;
+            parseConfig(config, std::string_view(data.begin(), data.size()), dir, path, pathname, true);
+        } catch (std::system_error &ex) {
+            CONFIG_DEBUG("loadDefaultOverrides")
+                << "CMRC exception while reading " << pathname << ": " << ex.what() << std::endl;
+        }
+#endif
     });
+}
 
-#ifdef CONFIG_CMRC_NAMESPACE
-    std::string pathname = path + ".toml";
+bool Manager::parseLazily(Config &config, std::shared_ptr<const MappedFile> file, const std::string &dir,
+                          const std::string &path, const std::string &pathname)
+{
+    if (!config.lazy.scan(file)) {
+        CONFIG_DEBUG("registerPath") << pathname << ": cannot split into tables, parsing completely" << std::endl;
+        return false;
+    }
+    if (!config.lazy.pending()) {
+        // no tables to defer
+        return false;
+    }
+
+    toml::table tbl;
     try {
-        std::string dir;
-
-        auto fs = cmrc::CONFIG_CMRC_NAMESPACE::get_filesystem();
-        auto data = fs.open(pathname);
-        pathname = "CMRC:" + pathname;
-        std::string s(data.begin(), data.end());
-        std::stringstream file(s);
-        parse_config(file, dir, path, pathname, true);
-    } catch (std::system_error &ex) {
-        debug("registerPath") << "CMRC exception while reading " << pathname << ": " << ex.what() << std::endl;
+        tbl = toml::parse(config.lazy.preamble(), pathname);
+    } catch (std::exception &) {
+        // let complete parse report errors
+        config.lazy.clear();
+        return false;
     }
-#endif
+    CONFIG_DEBUG("registerPath") << pathname << " OK, tables are parsed on first access" << std::endl;
 
-    for (const auto &infix: infixes) {
-        for (const auto &basedir: m_path) {
-            std::string dir = basedir + infix;
-            std::string pathname = dir + sep() + path + ".toml";
-            std::ifstream file(pathname);
-            if (file.fail()) {
-                debug("registerPath") << pathname << " not found" << std::endl;
+    std::lock_guard guard(config.mutex);
+    config.path = path;
+    config.base = dir;
+    config.config.reset(std::move(tbl));
+    config.snapshot.reset();
+    config.exists = true;
+    return true;
+}
+
+void Manager::materialize(Config &config, const std::string &section)
+{
+    if (!config.lazy.pending())
+        return;
+    std::lock_guard guard(config.mutex);
+    materializeLocked(config, section);
+}
+
+void Manager::materializeLocked(Config &config, const std::string &section, int depth, bool fragments)
+{
+    auto text = config.lazy.take(section);
+    if (!text.empty()) {
+        const std::string pathname = config.base + sep() + config.path + ".toml";
+        toml::table tbl;
+        try {
+            tbl = toml::parse(text, pathname);
+        } catch (toml::parse_error &ex) {
+            error("materialize") << ex << std::endl;
+            handleError();
+            return;
+        }
+        CONFIG_DEBUG("materialize") << pathname << ": parsed tables for section " << section << std::endl;
+
+        auto &root = config.config.root();
+        for (auto &&[key, node]: tbl) {
+            auto result = root.insert(key, std::move(node));
+            if (!result.second) {
+                error("materialize") << pathname << ": " << key.str() << " is already defined" << std::endl;
+                handleError();
                 continue;
             }
-            if (parse_config(file, dir, path, pathname))
-                return m_configs[path];
+            config.config.add(std::string(key.str()), &result.first->second);
         }
     }
 
-    config->path = path;
-    config->base = m_userPath;
-    return config;
+    if (!fragments)
+        return;
+    for (const auto &inc: config.lazy.takeIncludes(section))
+        includeFragment(config, inc, depth);
+}
+
+void Manager::registerIncludes(Config &config, const std::vector<std::string> &searchPath, const std::string &userPath)
+{
+    std::lock_guard guard(config.mutex);
+    materializeLocked(config, IncludeKey);
+    auto &root = config.config.root();
+    auto node = root.get(IncludeKey);
+    if (!node)
+        return;
+
+    const std::string pathname = config.base + sep() + config.path + ".toml";
+    auto tbl = node->as_table();
+    if (!tbl) {
+        error("registerPath") << pathname << ": " << IncludeKey << " has to be a table" << std::endl;
+        handleError();
+    } else {
+        config.includes = *tbl;
+        for (auto &&[key, value]: *tbl) {
+            auto fragment = value.value<std::string>();
+            if (!fragment || fragment->empty()) {
+                error("registerPath") << pathname << ": " << IncludeKey << "." << key.str()
+                                      << " has to name a configuration path" << std::endl;
+                handleError();
+                continue;
+            }
+            if (root.contains(key.str())) {
+                error("registerPath") << pathname << ": " << key.str() << " is already defined, not including "
+                                      << *fragment << std::endl;
+                handleError();
+                continue;
+            }
+            CONFIG_DEBUG("registerPath") << pathname << ": section " << key.str() << " is included from " << *fragment
+                                         << std::endl;
+            config.lazy.include(LazySections::Include{std::string(key.str()), *fragment, searchPath, userPath});
+        }
+    }
+    // directive is not a configuration value, it is kept in config.includes for saving
+    config.config.erase(root, "", IncludeKey);
+}
+
+void Manager::includeFragment(Config &config, const LazySections::Include &inc, int depth)
+{
+    const std::string pathname = config.base + sep() + config.path + ".toml";
+    if (depth >= MaxIncludeDepth) {
+        error("materialize") << pathname << ": not including " << inc.path << " for section " << inc.section
+                             << ", includes nested too deeply" << std::endl;
+        handleError();
+        return;
+    }
+
+    Config fragment;
+    loadConfig(fragment, inc.path, inc.searchPath, inc.userPath);
+    if (!fragment.exists) {
+        warn("materialize") << pathname << ": included " << inc.path << " for section " << inc.section
+                            << " not found" << std::endl;
+        return;
+    }
+    std::lock_guard guard(fragment.mutex);
+    materializeLocked(fragment, std::string(), depth + 1);
+    CONFIG_DEBUG("materialize") << pathname << ": included " << fragment.base << sep() << inc.path
+                                << ".toml for section " << inc.section << std::endl;
+
+    auto &root = config.config.root();
+    auto result = root.insert(inc.section, std::move(fragment.config.root()));
+    if (!result.second) {
+        error("materialize") << pathname << ": " << inc.section << " is already defined, not including " << inc.path
+                             << std::endl;
+        handleError();
+        return;
+    }
+    config.config.add(inc.section, &result.first->second);
+    config.included.insert(inc.section);
+}
+
+Entry *Manager::addEntry(uint64_t hash, ConfigKey key, Entry *entry)
+{
+    auto lock = m_entries.lock(hash);
+    // check again, might have been created concurrently
+    if (auto existing = m_entries.find(hash, key.path, key.section, key.name))
+        return existing;
+    entry->m_handle = m_table.add(entry);
+    if (entry->m_handle == EntryTable::InvalidHandle) {
+        // entry remains accessible by name, but handles cannot be resolved to it
+        error("addEntry") << "too many entries, no handle for " << key << std::endl;
+        handleError();
+    }
+    m_entries.insert(hash, std::move(key), entry);
+    return entry;
+}
+
+uint32_t Manager::generation() const
+{
+    return m_generation;
+}
+
+Entry *Manager::entry(uint32_t handle, uint32_t generation)
+{
+    if (generation != m_generation || handle >= m_table.size()) {
+        error("entry") << "handle " << handle << " has not been resolved by this instance (generation " << generation
+                       << ", current generation " << m_generation << ")" << std::endl;
+        handleError();
+        return nullptr;
+    }
+    return m_table.get(handle);
 }
 
 bool Manager::sendToWorkspace(const ConfigBase *entry)
@@ -370,16 +936,22 @@ bool Manager::sendToWorkspace(const ConfigBase *entry)
     return m_bridge->wasChanged(entry);
 }
 
-static void pruneEmptySections(toml::v3::table *tbl)
+static void pruneEmptySections(IndexedTable &tree, toml::table *tbl, const std::string &key = std::string())
 {
     if (!tbl)
         return;
     auto it = tbl->begin();
     while (it != tbl->end()) {
-        toml::v3::table *t = it->second.as_table();
-        pruneEmptySections(t);
-        if (t && t->empty()) {
+        toml::table *t = it->second.as_table();
+        if (!t) {
+            ++it;
+            continue;
+        }
+        const auto k = IndexedTable::child_key(key, it->first.str());
+        pruneEmptySections(tree, t, k);
+        if (t->empty()) {
             // it->second is a table and an empty one: prune
+            tree.remove(k);
             it = tbl->erase(it);
         } else {
             ++it;
@@ -401,29 +973,70 @@ bool Manager::save(const std::string &path)
         return false;
     }
 
-    auto &config = it->second->config;
-
-    pruneEmptySections(&config);
-
     std::string pathname = m_userPath + sep() + path + ".toml";
     std::string backup = pathname + ".backup";
-    if (config.empty()) { // do not save empty config files
+    // contents have been read from or written to pathname, and they have not changed since
+    const bool unchanged = !it->second->modified && (it->second->base == m_userPath || it->second->savedHash != 0);
+    if (unchanged && std::filesystem::exists(pathname)) {
+        CONFIG_DEBUG("save") << pathname << " is up to date" << std::endl;
+        return true;
+    }
+
+    // fragments are not loaded, as only the directive including them is saved
+    materializeLocked(*it->second, std::string(), 0, false);
+
+    auto &config = it->second->config.root();
+
+    pruneEmptySections(it->second->config, &config);
+
+    // sections included from fragments belong to other files
+    const auto &included = it->second->included;
+    bool owned = false;
+    for (auto &&[key, node]: config) {
+        if (included.count(std::string(key.str())) == 0) {
+            owned = true;
+            break;
+        }
+    }
+    if (!owned && it->second->includes.empty()) { // do not save empty config files
         if (std::remove(pathname.c_str()) == 0) {
             it->second->modified = false;
+            it->second->savedHash = 0;
+            RetainedConfigs::the().forget(path);
             return true;
         }
         return false;
     }
 
+    std::stringstream str;
+    if (it->second->includes.empty()) {
+        str << config;
+    } else {
+        toml::table out;
+        out.insert(IncludeKey, it->second->includes);
+        for (auto &&[key, node]: config) {
+            if (included.count(std::string(key.str())) == 0)
+                out.insert(key, node);
+        }
+        str << out;
+    }
+    const std::string contents = str.str();
+    const uint64_t hash = fnv1a(contents);
+    if (hash == it->second->savedHash && std::filesystem::exists(pathname)) {
+        // changes have been reverted
+        CONFIG_DEBUG("save") << pathname << " is up to date, contents unchanged" << std::endl;
+        it->second->modified = false;
+        return true;
+    }
+
     std::filesystem::create_directories(m_userPath);
 
     std::string temp = pathname + ".new";
-    if (!config.empty()) {
-        try {
-            std::ofstream f(temp);
-            f << config;
-        } catch (std::exception &ex) {
-            error("save") << "failed to save config to " << temp << ": " << ex.what() << std::endl;
+    {
+        std::ofstream f(temp, std::ios::binary);
+        f << contents;
+        if (!f) {
+            error("save") << "failed to save config to " << temp << std::endl;
             return false;
         }
     }
@@ -433,12 +1046,15 @@ bool Manager::save(const std::string &path)
         std::rename(pathname.c_str(), backup.c_str());
         std::remove(pathname.c_str());
     }
-    if (!config.empty() && std::rename(temp.c_str(), pathname.c_str()) != 0) {
+    if (std::rename(temp.c_str(), pathname.c_str()) != 0) {
         error("save") << "failed to move updated config to " << pathname << std::endl;
         return false;
     }
 
     it->second->modified = false;
+    it->second->savedHash = hash;
+    // later instances have to read the saved file instead of one found before
+    RetainedConfigs::the().forget(path);
 
     return true;
 }
@@ -449,7 +1065,7 @@ bool Manager::saveAllAutosave()
     bool ok = true;
     for (auto &c: m_configs) {
         if (c.second->autosave) {
-            debug("~") << "saving " << c.first << std::endl;
+            CONFIG_DEBUG("~") << "saving " << c.first << std::endl;
             if (!save(c.first)) {
                 ok = false;
             }
@@ -458,25 +1074,19 @@ bool Manager::saveAllAutosave()
     return ok;
 }
 
-std::ostream &operator<<(std::ostream &os, const ConfigKey &key)
-{
-    os << key.path << ":" << key.section << ":" << key.name;
-    return os;
-}
-
-template ValueEntry<bool> *Manager::getValue(const std::string &, const std::string &, const std::string &, Flag);
-template ValueEntry<int64_t> *Manager::getValue(const std::string &, const std::string &, const std::string &, Flag);
-template ValueEntry<double> *Manager::getValue(const std::string &, const std::string &, const std::string &, Flag);
-template ValueEntry<std::string> *Manager::getValue(const std::string &, const std::string &, const std::string &,
+template ValueEntry<bool> *Manager::getValue(uint64_t, std::string_view, std::string_view, std::string_view, Flag);
+template ValueEntry<int64_t> *Manager::getValue(uint64_t, std::string_view, std::string_view, std::string_view, Flag);
+template ValueEntry<double> *Manager::getValue(uint64_t, std::string_view, std::string_view, std::string_view, Flag);
+template ValueEntry<std::string> *Manager::getValue(uint64_t, std::string_view, std::string_view, std::string_view,
                                                     Flag);
-template ValueEntry<config::Section> *Manager::getValue(const std::string &, const std::string &, const std::string &,
+template ValueEntry<config::Section> *Manager::getValue(uint64_t, std::string_view, std::string_view, std::string_view,
                                                         Flag);
-template ArrayEntry<bool> *Manager::getArray(const std::string &, const std::string &, const std::string &, Flag);
-template ArrayEntry<int64_t> *Manager::getArray(const std::string &, const std::string &, const std::string &, Flag);
-template ArrayEntry<double> *Manager::getArray(const std::string &, const std::string &, const std::string &, Flag);
-template ArrayEntry<std::string> *Manager::getArray(const std::string &, const std::string &, const std::string &,
+template ArrayEntry<bool> *Manager::getArray(uint64_t, std::string_view, std::string_view, std::string_view, Flag);
+template ArrayEntry<int64_t> *Manager::getArray(uint64_t, std::string_view, std::string_view, std::string_view, Flag);
+template ArrayEntry<double> *Manager::getArray(uint64_t, std::string_view, std::string_view, std::string_view, Flag);
+template ArrayEntry<std::string> *Manager::getArray(uint64_t, std::string_view, std::string_view, std::string_view,
                                                     Flag);
-template ArrayEntry<config::Section> *Manager::getArray(const std::string &, const std::string &, const std::string &,
+template ArrayEntry<config::Section> *Manager::getArray(uint64_t, std::string_view, std::string_view, std::string_view,
                                                         Flag);
 
 } // namespace detail
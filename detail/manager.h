@@ -8,12 +8,22 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <set>
+#include <future>
+#include <string_view>
 #include <functional>
 #include <mutex>
+#include <shared_mutex>
 
 #include "entry.h"
 #include "base.h"
 #include "logger.h"
+#include "tomlaccess.h"
+#include "registry.h"
+#include "dircache.h"
+#include "lazysections.h"
+#include "treecache.h"
+#include "hash.h"
 #include "../section.h"
 
 #include "toml/toml.hpp"
@@ -26,37 +36,41 @@ namespace config {
 
 class Access;
 class Bridge;
+class Collective;
 
 namespace detail {
 
 struct Config {
     std::string path; // path fragment
     std::string base; // base directory
-    toml::table config; // value storage
-    toml::table defaultOverrides; // default value overrides from resource files
+    IndexedTable config; // value storage
+    IndexedTable defaultOverrides; // default value overrides from resource files, see Manager::loadDefaultOverrides
     bool exists = false; // does file exist?
-    bool modified = false;
+    bool modified = false; // do contents differ from file they were read from or last saved to?
+    uint64_t savedHash = 0; // hash of contents last written by Manager::save, 0 if never written
     bool autosave = false; // save on exit?
-    std::mutex mutex;
+    std::shared_mutex mutex; // guards config and defaultOverrides: shared for reading, exclusive for modification
+    std::shared_future<void> loaded; // ready once file has been read
+    std::once_flag overridesLoaded; // defaultOverrides are parsed on first use
+    LazySections lazy; // tables of config that have not been parsed yet, see Manager::materialize
+    TreeCache::Reference snapshot; // keeps snapshot shared with other managers and library instances alive
+    toml::table includes; // directive mapping sections to fragments, written back when saving
+    std::set<std::string> included; // top-level sections provided by fragments, not saved
 };
 
-struct ConfigKey {
+/// loading of a configuration path claimed by a thread, to be executed without holding the manager lock
+struct LoadJob {
+    std::shared_ptr<Config> config;
     std::string path;
-    std::string section;
-    std::string name;
-
-    bool operator<(const ConfigKey &o) const
-    {
-        if (path == o.path) {
-            if (section == o.section) {
-                return name < o.name;
-            }
-            return section < o.section;
-        }
-        return path < o.path;
-    }
+    std::vector<std::string> searchPath;
+    std::string userPath;
+    std::promise<void> loaded; // fulfills Config::loaded
+    bool received = false; // common file was read by the root of a collective load, search only specific ones
+    bool exists = false; // whether root of collective load found a common file
+    std::string base; // directory where root found the common file
+    std::string pathname; // common file read by root
+    std::string contents; // contents of common file read by root
 };
-std::ostream &operator<<(std::ostream &os, const ConfigKey &key);
 
 class Manager: Logger {
     friend class config::Access;
@@ -70,9 +84,25 @@ public:
 
     std::shared_ptr<Config> registerPath(const std::string &path);
     template<class V>
-    ValueEntry<V> *getValue(const std::string &path, const std::string &section, const std::string &name, Flag flags);
+    ValueEntry<V> *getValue(std::string_view path, std::string_view section, std::string_view name, Flag flags)
+    {
+        return getValue<V>(hash_key(path, section, name), path, section, name, flags);
+    }
+    template<class V>
+    ValueEntry<V> *getValue(uint64_t hash, std::string_view path, std::string_view section, std::string_view name,
+                            Flag flags); ///< lookup with hash_key computed by caller, e.g. at compile time
+    template<class V>
+    ArrayEntry<V> *getArray(std::string_view path, std::string_view section, std::string_view name, Flag flags)
+    {
+        return getArray<V>(hash_key(path, section, name), path, section, name, flags);
+    }
     template<class V>
-    ArrayEntry<V> *getArray(const std::string &path, const std::string &section, const std::string &name, Flag flags);
+    ArrayEntry<V> *getArray(uint64_t hash, std::string_view path, std::string_view section, std::string_view name,
+                            Flag flags); ///< lookup with hash_key computed by caller, e.g. at compile time
+    uint32_t generation() const; ///< distinguishes this instance from earlier ones, for tagging handles
+    Entry *entry(uint32_t handle, uint32_t generation); ///< null if handle was not resolved by this instance
+    void loadDefaultOverrides(Config &config); ///< parse resource file for config, if not yet done
+    void materialize(Config &config, const std::string &section); ///< parse tables for section, all if empty
 
     bool save(const std::string &path);
 
@@ -93,10 +123,32 @@ private:
     bool release();
     void reconfigure();
     bool saveAllAutosave();
+    Entry *addEntry(uint64_t hash, ConfigKey key, Entry *entry); ///< returns entry registered first for key
+    std::shared_ptr<Config> claimPath(const std::string &path, std::unique_ptr<LoadJob> &job);
+    void runJob(LoadJob &job);
+    void runJobs(const std::vector<std::unique_ptr<LoadJob>> &jobs);
+    void load(const std::vector<std::string> &paths);
+    void load(const std::vector<std::string> &paths, Collective &collective);
+    void prefetch(const std::vector<std::string> &paths);
+    bool loadConfig(Config &config, const std::string &path, const std::vector<std::string> &searchPath,
+                    const std::string &userPath,
+                    bool specificOnly = false); ///< returns whether a file was found, optionally for host or cluster
+    std::string findCommon(const std::string &path,
+                           const std::vector<std::string> &searchPath); ///< directory of file common to all hosts
+    bool parseConfig(Config &config, std::string_view contents, const std::string &dir, const std::string &path,
+                     const std::string &pathname, bool overrideDefaults = false);
+    bool parseLazily(Config &config, std::shared_ptr<const MappedFile> file, const std::string &dir,
+                     const std::string &path, const std::string &pathname);
+    void materializeLocked(Config &config, const std::string &section, int depth = 0,
+                           bool fragments = true); ///< requires exclusive lock on config
+    void registerIncludes(Config &config, const std::vector<std::string> &searchPath, const std::string &userPath);
+    void includeFragment(Config &config, const LazySections::Include &inc, int depth); ///< requires exclusive lock
 
     std::string m_hostname;
     std::string m_cluster;
     int m_rank = -1;
+    uint32_t m_generation = 0; // tag of handles resolved by this instance
+    bool m_lazy = false; // defer parsing tables of large files
 
     std::recursive_mutex m_mutex;
     int m_useCount = 0;
@@ -105,35 +157,38 @@ private:
     std::string m_installPrefix;
     std::vector<std::string> m_path;
     std::map<std::string, std::shared_ptr<Config>> m_configs;
+    std::vector<std::future<void>> m_background; // configurations being loaded asynchronously
 
-    typedef ConfigKey Key;
-    std::map<Key, Entry *> m_entries;
+    DirectoryCache m_dirCache; // contents of search directories
+    TreeCache m_treeCache; // binary snapshots of parsed files
+    EntryRegistry m_entries;
+    EntryTable m_table; // all entries, indexed by their handle
     Bridge *m_bridge = nullptr;
 
     std::function<void()> m_errorHandler;
     bool m_noWorkspaceWarning = false;
 };
 
-extern template ValueEntry<bool> *Manager::getValue(const std::string &, const std::string &, const std::string &,
+extern template ValueEntry<bool> *Manager::getValue(uint64_t, std::string_view, std::string_view, std::string_view,
                                                     Flag);
-extern template ValueEntry<int64_t> *Manager::getValue(const std::string &, const std::string &, const std::string &,
+extern template ValueEntry<int64_t> *Manager::getValue(uint64_t, std::string_view, std::string_view, std::string_view,
                                                        Flag);
-extern template ValueEntry<double> *Manager::getValue(const std::string &, const std::string &, const std::string &,
+extern template ValueEntry<double> *Manager::getValue(uint64_t, std::string_view, std::string_view, std::string_view,
                                                       Flag);
-extern template ValueEntry<std::string> *Manager::getValue(const std::string &, const std::string &,
-                                                           const std::string &, Flag);
-extern template ValueEntry<config::Section> *Manager::getValue(const std::string &, const std::string &,
-                                                               const std::string &, Flag);
-extern template ArrayEntry<bool> *Manager::getArray(const std::string &, const std::string &, const std::string &,
+extern template ValueEntry<std::string> *Manager::getValue(uint64_t, std::string_view, std::string_view,
+                                                           std::string_view, Flag);
+extern template ValueEntry<config::Section> *Manager::getValue(uint64_t, std::string_view, std::string_view,
+                                                               std::string_view, Flag);
+extern template ArrayEntry<bool> *Manager::getArray(uint64_t, std::string_view, std::string_view, std::string_view,
                                                     Flag);
-extern template ArrayEntry<int64_t> *Manager::getArray(const std::string &, const std::string &, const std::string &,
+extern template ArrayEntry<int64_t> *Manager::getArray(uint64_t, std::string_view, std::string_view, std::string_view,
                                                        Flag);
-extern template ArrayEntry<double> *Manager::getArray(const std::string &, const std::string &, const std::string &,
+extern template ArrayEntry<double> *Manager::getArray(uint64_t, std::string_view, std::string_view, std::string_view,
                                                       Flag);
-extern template ArrayEntry<std::string> *Manager::getArray(const std::string &, const std::string &,
-                                                           const std::string &, Flag);
-extern template ArrayEntry<config::Section> *Manager::getArray(const std::string &, const std::string &,
-                                                               const std::string &, Flag);
+extern template ArrayEntry<std::string> *Manager::getArray(uint64_t, std::string_view, std::string_view,
+                                                           std::string_view, Flag);
+extern template ArrayEntry<config::Section> *Manager::getArray(uint64_t, std::string_view, std::string_view,
+                                                               std::string_view, Flag);
 
 } // namespace detail
 } // namespace config
@@ -15,50 +15,60 @@ namespace config {
 namespace detail {
 
 template<class V>
-ValueEntry<V> *Manager::getValue(const std::string &path, const std::string &section, const std::string &name,
-                                 Flag flags)
+ValueEntry<V> *Manager::getValue(uint64_t hash, std::string_view path, std::string_view section,
+                                 std::string_view name, Flag flags)
 {
-    Key key{path, section, name};
-    std::lock_guard guard(m_mutex);
-    auto it = m_entries.find(key);
-    if (it == m_entries.end()) {
-        it = m_entries.emplace(key, new ValueEntry<V>(this, path, section, name, flags)).first;
-        auto ent = dynamic_cast<ValueEntry<V> *>(it->second);
-        debug("getValue") << key << " new, value: " << ent->value() << std::endl;
-        return ent;
+    auto entry = m_entries.find(hash, path, section, name);
+    if (!entry) {
+        // construction might have to load the configuration file, so no lock is held
+        ConfigKey key{std::string(path), std::string(section), std::string(name)};
+        auto ent = new ValueEntry<V>(this, key.path, key.section, key.name, flags);
+        entry = addEntry(hash, std::move(key), ent);
+        if (entry == ent) {
+            CONFIG_DEBUG("getValue") << ent->key() << " new, value: " << ent->value() << std::endl;
+            return ent;
+        }
+        // created concurrently by another thread
+        delete ent;
     }
 
-    auto ent = dynamic_cast<ValueEntry<V> *>(it->second);
-    if (!ent) {
-        error("getValue") << key << " already registered with a different type" << std::endl;
+    if (entry->type() != value_tag<V>()) {
+        error("getValue") << entry->key() << " already registered with a different type" << std::endl;
         handleError();
+        return nullptr;
     }
-    debug("getValue") << key << " found, existing value: " << ent->value() << ", default: " << ent->defaultValue()
-                      << std::endl;
+    auto ent = static_cast<ValueEntry<V> *>(entry);
+    CONFIG_DEBUG("getValue") << entry->key() << " found, existing value: " << ent->value()
+                             << ", default: " << ent->defaultValue() << std::endl;
     return ent;
 }
 
 template<class V>
-ArrayEntry<V> *Manager::getArray(const std::string &path, const std::string &section, const std::string &name,
-                                 Flag flags)
+ArrayEntry<V> *Manager::getArray(uint64_t hash, std::string_view path, std::string_view section,
+                                 std::string_view name, Flag flags)
 {
-    Key key{path, section, name};
-    std::lock_guard guard(m_mutex);
-    auto it = m_entries.find(key);
-    if (it == m_entries.end()) {
-        it = m_entries.emplace(key, new ArrayEntry<V>(this, path, section, name, flags)).first;
-        auto ent = dynamic_cast<ArrayEntry<V> *>(it->second);
-        debug("getArray") << key << " new, array: " << ent->value() << std::endl;
-        return ent;
+    auto entry = m_entries.find(hash, path, section, name);
+    if (!entry) {
+        // construction might have to load the configuration file, so no lock is held
+        ConfigKey key{std::string(path), std::string(section), std::string(name)};
+        auto ent = new ArrayEntry<V>(this, key.path, key.section, key.name, flags);
+        entry = addEntry(hash, std::move(key), ent);
+        if (entry == ent) {
+            CONFIG_DEBUG("getArray") << ent->key() << " new, array: " << ent->value() << std::endl;
+            return ent;
+        }
+        // created concurrently by another thread
+        delete ent;
     }
 
-    auto ent = dynamic_cast<ArrayEntry<V> *>(it->second);
-    if (!ent) {
-        error("getArray") << key << " already registered with a different type" << std::endl;
+    if (entry->type() != array_tag<V>()) {
+        error("getArray") << entry->key() << " already registered with a different type" << std::endl;
         handleError();
+        return nullptr;
     }
-    debug("getArray") << key << " found, existing array: " << ent->value() << ", default: " << ent->defaultValue()
-                      << std::endl;
+    auto ent = static_cast<ArrayEntry<V> *>(entry);
+    CONFIG_DEBUG("getArray") << entry->key() << " found, existing array: " << ent->value()
+                             << ", default: " << ent->defaultValue() << std::endl;
     return ent;
 }
 
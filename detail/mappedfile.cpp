@@ -0,0 +1,154 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#include <filesystem>
+#include <fstream>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+#ifndef _WIN32
+namespace {
+
+int64_t mtime_of(const struct stat &st)
+{
+#ifdef __APPLE__
+    return int64_t(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    return int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+}
+
+} // namespace
+#endif
+
+bool MappedFile::stat(const std::string &pathname, uint64_t &size, int64_t &mtime)
+{
+#ifdef _WIN32
+    std::error_code ec;
+    size = std::filesystem::file_size(pathname, ec);
+    if (ec)
+        return false;
+    auto t = std::filesystem::last_write_time(pathname, ec);
+    if (ec)
+        return false;
+    mtime = t.time_since_epoch().count();
+    return true;
+#else
+    struct stat st;
+    if (::stat(pathname.c_str(), &st) == -1)
+        return false;
+    size = st.st_size;
+    mtime = mtime_of(st);
+    return true;
+#endif
+}
+
+MappedFile::MappedFile(const std::string &pathname)
+{
+#ifndef _WIN32
+    int fd = open(pathname.c_str(), O_RDONLY);
+    if (fd == -1)
+        return;
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return;
+    }
+    m_size = st.st_size;
+    m_mtime = mtime_of(st);
+    if (m_size >= MapThreshold) {
+        void *map = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            m_map = map;
+            m_valid = true;
+            close(fd);
+            return;
+        }
+    }
+    m_buffer.resize(m_size);
+    size_t total = 0;
+    while (total < m_size) {
+        auto n = read(fd, &m_buffer[total], m_size - total);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        total += n;
+    }
+    close(fd);
+    if (total != m_size) {
+        m_buffer.clear();
+        m_size = 0;
+        return;
+    }
+    m_valid = true;
+#else
+    std::ifstream file(pathname, std::ios::binary);
+    if (!file)
+        return;
+    std::error_code ec;
+    m_mtime = std::filesystem::last_write_time(pathname, ec).time_since_epoch().count();
+    file.seekg(0, std::ios::end);
+    m_size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    m_buffer.resize(m_size);
+    file.read(&m_buffer[0], m_size);
+    if (static_cast<size_t>(file.gcount()) != m_size) {
+        m_buffer.clear();
+        m_size = 0;
+        return;
+    }
+    m_valid = true;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if (m_map)
+        munmap(m_map, m_size);
+#endif
+}
+
+bool MappedFile::valid() const
+{
+    return m_valid;
+}
+
+std::string_view MappedFile::data() const
+{
+    if (m_map)
+        return std::string_view(static_cast<const char *>(m_map), m_size);
+    return m_buffer;
+}
+
+size_t MappedFile::size() const
+{
+    return m_size;
+}
+
+int64_t MappedFile::mtime() const
+{
+    return m_mtime;
+}
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
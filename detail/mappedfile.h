@@ -0,0 +1,50 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file mappedfile.h
+/// read-only access to file contents without copying through stream buffers
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+/// contents of a file, memory-mapped if it is large
+/** small files are read with a single read call, as mapping them costs more than copying */
+class MappedFile {
+public:
+    static constexpr size_t MapThreshold = 64 * 1024; ///< map files at least this large
+
+    explicit MappedFile(const std::string &pathname);
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    static bool stat(const std::string &pathname, uint64_t &size,
+                     int64_t &mtime); ///< query size and modification time, comparable to \ref mtime
+
+    bool valid() const; ///< whether file could be opened and read
+    std::string_view data() const; ///< file contents, valid as long as this object exists
+    size_t size() const;
+    int64_t mtime() const; ///< modification time of the file that was read, as of opening it
+
+private:
+    bool m_valid = false;
+    void *m_map = nullptr;
+    size_t m_size = 0;
+    int64_t m_mtime = 0;
+    std::string m_buffer;
+};
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
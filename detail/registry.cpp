@@ -0,0 +1,151 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "registry.h"
+
+#include <cassert>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+EntryRegistry::~EntryRegistry()
+{
+    clear();
+}
+
+EntryRegistry::Table::Table(size_t size): mask(size - 1), buckets(new std::atomic<Link *>[size]())
+{
+    assert((size & mask) == 0);
+}
+
+void EntryRegistry::Table::link(const Node *node)
+{
+    auto &head = buckets[node->hash & mask];
+    auto &l = links.emplace_back(Link{node, head.load(std::memory_order_relaxed)});
+    // publish completely initialized link to concurrent readers
+    head.store(&l, std::memory_order_release);
+}
+
+EntryRegistry::Shard &EntryRegistry::shard(uint64_t hash)
+{
+    // use independent bits of the hash for selecting shard and bucket
+    return m_shards[(hash >> 32) % NumShards];
+}
+
+const EntryRegistry::Shard &EntryRegistry::shard(uint64_t hash) const
+{
+    return m_shards[(hash >> 32) % NumShards];
+}
+
+Entry *EntryRegistry::find(uint64_t hash, std::string_view path, std::string_view section,
+                           std::string_view name) const
+{
+    auto table = shard(hash).table.load(std::memory_order_acquire);
+    if (!table)
+        return nullptr;
+    for (auto l = table->buckets[hash & table->mask].load(std::memory_order_acquire); l; l = l->next) {
+        const auto node = l->node;
+        if (node->hash != hash)
+            continue;
+        const auto &key = node->key;
+        if (key.name == name && key.section == section && key.path == path)
+            return node->entry;
+    }
+    return nullptr;
+}
+
+std::unique_lock<std::mutex> EntryRegistry::lock(uint64_t hash)
+{
+    return std::unique_lock<std::mutex>(shard(hash).mutex);
+}
+
+void EntryRegistry::insert(uint64_t hash, ConfigKey key, Entry *entry)
+{
+    auto &s = shard(hash);
+    s.nodes.emplace_back(new Node{hash, std::move(key), entry});
+    auto table = s.table.load(std::memory_order_relaxed);
+    if (!table || s.nodes.size() > (table->mask + 1) * MaxLoad) {
+        // readers still traversing the previous table find all entries that were there before
+        s.tables.emplace_back(new Table(table ? (table->mask + 1) * 2 : InitialBuckets));
+        table = s.tables.back().get();
+        for (const auto &node: s.nodes)
+            table->link(node.get());
+        s.table.store(table, std::memory_order_release);
+    } else {
+        table->link(s.nodes.back().get());
+    }
+    ++m_size;
+}
+
+size_t EntryRegistry::size() const
+{
+    return m_size;
+}
+
+void EntryRegistry::clear()
+{
+    for (auto &s: m_shards) {
+        s.table.store(nullptr);
+        s.tables.clear();
+        s.nodes.clear();
+    }
+    m_size = 0;
+}
+
+EntryTable::~EntryTable()
+{
+    clear();
+}
+
+uint32_t EntryTable::add(Entry *entry)
+{
+    std::lock_guard guard(m_mutex);
+    const size_t handle = m_size.load(std::memory_order_relaxed);
+    const size_t c = handle / ChunkSize;
+    if (c >= MaxChunks)
+        return InvalidHandle;
+    auto chunk = m_chunks[c].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new Chunk{};
+        m_chunks[c].store(chunk, std::memory_order_release);
+    }
+    (*chunk)[handle % ChunkSize].store(entry, std::memory_order_relaxed);
+    m_size.store(handle + 1, std::memory_order_release);
+    return static_cast<uint32_t>(handle);
+}
+
+Entry *EntryTable::get(uint32_t handle) const
+{
+    assert(handle < m_size.load(std::memory_order_acquire));
+    auto chunk = m_chunks[handle / ChunkSize].load(std::memory_order_acquire);
+    return (*chunk)[handle % ChunkSize].load(std::memory_order_acquire);
+}
+
+size_t EntryTable::size() const
+{
+    return m_size.load(std::memory_order_acquire);
+}
+
+void EntryTable::clear()
+{
+    for (auto &c: m_chunks) {
+        delete c.exchange(nullptr);
+    }
+    m_size = 0;
+}
+
+std::ostream &operator<<(std::ostream &os, const ConfigKey &key)
+{
+    os << key.path << ":" << key.section << ":" << key.name;
+    return os;
+}
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -0,0 +1,118 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file registry.h
+/// lookup of configuration entries by path, section and name
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+class Entry;
+
+struct ConfigKey {
+    std::string path;
+    std::string section;
+    std::string name;
+};
+std::ostream &operator<<(std::ostream &os, const ConfigKey &key);
+
+/// hashed storage of \ref Entry pointers, queried without constructing strings
+/** keys are hashed with \ref hash_key, which can also be precomputed by the caller.
+    Storage is split into shards selected by the hash, each with its own lock for inserting.
+    The buckets of a shard are doubled once it holds more than two entries per bucket.
+    Entries are never removed before \ref clear, and bucket arrays that have been replaced are kept until then,
+    so that \ref find does not need to lock at all. */
+class EntryRegistry {
+public:
+    EntryRegistry() = default;
+    EntryRegistry(const EntryRegistry &) = delete;
+    EntryRegistry &operator=(const EntryRegistry &) = delete;
+    ~EntryRegistry();
+
+    Entry *find(uint64_t hash, std::string_view path, std::string_view section, std::string_view name) const;
+    std::unique_lock<std::mutex> lock(uint64_t hash); ///< serialize insertion of entries in the shard for hash
+    void insert(uint64_t hash, ConfigKey key, Entry *entry); ///< requires \ref lock to be held
+    size_t size() const;
+    void clear(); ///< requires that no other thread accesses the registry
+
+private:
+    static constexpr size_t NumShards = 64;
+    static constexpr size_t InitialBuckets = 16; // per shard, a power of 2
+    static constexpr size_t MaxLoad = 2; // average chain length triggering growth
+
+    struct Node {
+        uint64_t hash = 0;
+        ConfigKey key;
+        Entry *entry = nullptr;
+    };
+    struct Link {
+        const Node *node = nullptr;
+        Link *next = nullptr;
+    };
+    struct Table {
+        explicit Table(size_t size);
+        const size_t mask;
+        std::unique_ptr<std::atomic<Link *>[]> buckets;
+        std::deque<Link> links; // chains through buckets, never moved when appending
+        void link(const Node *node);
+    };
+    struct Shard {
+        std::mutex mutex;
+        std::atomic<Table *> table{nullptr};
+        std::vector<std::unique_ptr<Node>> nodes; // only accessed with mutex held
+        std::vector<std::unique_ptr<Table>> tables; // current and replaced tables, only accessed with mutex held
+    };
+
+    Shard &shard(uint64_t hash);
+    const Shard &shard(uint64_t hash) const;
+
+    std::array<Shard, NumShards> m_shards;
+    std::atomic<size_t> m_size{0};
+};
+
+/// dense table of entries indexed by their handle, readable without locking
+class EntryTable {
+public:
+    EntryTable() = default;
+    EntryTable(const EntryTable &) = delete;
+    EntryTable &operator=(const EntryTable &) = delete;
+    ~EntryTable();
+
+    static constexpr uint32_t InvalidHandle = ~uint32_t(0);
+
+    uint32_t add(Entry *entry); ///< store entry and return its handle, InvalidHandle if table is full
+    Entry *get(uint32_t handle) const;
+    size_t size() const; ///< number of entries that are completely stored
+    void clear(); ///< requires that no other thread accesses the table
+
+private:
+    static constexpr size_t ChunkSize = 1024;
+    static constexpr size_t MaxChunks = 4096;
+
+    typedef std::array<std::atomic<Entry *>, ChunkSize> Chunk;
+
+    std::mutex m_mutex; // for adding entries
+    std::array<std::atomic<Chunk *>, MaxChunks> m_chunks{};
+    std::atomic<size_t> m_size{0};
+};
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -0,0 +1,79 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "retention.h"
+#include "mappedfile.h"
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+RetainedConfigs &RetainedConfigs::the()
+{
+    static RetainedConfigs retained;
+    return retained;
+}
+
+void RetainedConfigs::setEnabled(bool enable)
+{
+    std::lock_guard guard(m_mutex);
+    m_enabled = enable;
+    if (!m_enabled)
+        m_files.clear();
+}
+
+bool RetainedConfigs::enabled() const
+{
+    std::lock_guard guard(m_mutex);
+    return m_enabled;
+}
+
+std::shared_ptr<const RetainedConfigs::File> RetainedConfigs::find(const std::string &key)
+{
+    std::shared_ptr<const File> file;
+    {
+        std::lock_guard guard(m_mutex);
+        auto it = m_files.find(key);
+        if (it == m_files.end())
+            return nullptr;
+        file = it->second;
+    }
+
+    // validate without holding the lock
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    if (MappedFile::stat(file->pathname, size, mtime) && size == file->size && mtime == file->mtime)
+        return file;
+
+    std::lock_guard guard(m_mutex);
+    auto it = m_files.find(key);
+    if (it != m_files.end() && it->second == file)
+        m_files.erase(it);
+    return nullptr;
+}
+
+void RetainedConfigs::store(const std::string &key, File file)
+{
+    std::lock_guard guard(m_mutex);
+    if (!m_enabled)
+        return;
+    m_files[key] = std::make_shared<const File>(std::move(file));
+}
+
+void RetainedConfigs::forget(const std::string &path)
+{
+    const std::string prefix = path + '\n';
+    std::lock_guard guard(m_mutex);
+    auto it = m_files.lower_bound(prefix);
+    while (it != m_files.end() && it->first.compare(0, prefix.size(), prefix) == 0)
+        it = m_files.erase(it);
+}
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -0,0 +1,58 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file retention.h
+/// parsed configuration files kept for reuse by later Manager instances
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "toml/toml.hpp"
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+/// process-wide store of parsed configuration files, outliving the Manager that loaded them
+/** Disabled by default, enable with \ref Access::retainConfiguration.
+    A retained file is reused only if its size and modification time are unchanged
+    and no file has been added in a directory that is searched earlier. */
+class RetainedConfigs {
+public:
+    /// pristine contents of a configuration file, as they were after loading
+    struct File {
+        std::string base; ///< directory where file was found
+        std::string pathname; ///< file that was loaded
+        uint64_t size = 0; ///< size of file when it was loaded
+        int64_t mtime = 0; ///< modification time of file when it was loaded, see \ref MappedFile::mtime
+        std::shared_ptr<const toml::table> config; ///< parsed file
+    };
+
+    static RetainedConfigs &the();
+
+    void setEnabled(bool enable); ///< disabling also forgets all retained files
+    bool enabled() const;
+    std::shared_ptr<const File> find(const std::string &key); ///< lookup file, if it is still up to date
+    void store(const std::string &key, File file); ///< retain file, if retention is enabled
+    void forget(const std::string &path); ///< drop all files retained for configuration path, e.g. after saving it
+
+private:
+    RetainedConfigs() = default;
+
+    mutable std::mutex m_mutex;
+    bool m_enabled = false;
+    std::map<std::string, std::shared_ptr<const File>> m_files;
+};
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -0,0 +1,154 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "sharedcache.h"
+
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+// weak and visible, so that all library instances within a process resolve to the same definition
+#if defined(__GNUC__) && !defined(_WIN32)
+#define COVCONFIG_SHARED_SYMBOL __attribute__((weak, visibility("default")))
+#else
+#define COVCONFIG_SHARED_SYMBOL
+#endif
+
+namespace {
+
+typedef std::shared_ptr<const std::string> Data;
+
+// never destroyed, as references might be released during exit
+std::mutex &shared_mutex()
+{
+    static auto mutex = new std::mutex;
+    return *mutex;
+}
+
+// entries expire when the last reference is released
+std::map<std::string, std::weak_ptr<const std::string>> &shared_data()
+{
+    static auto data = new std::map<std::string, std::weak_ptr<const std::string>>;
+    return *data;
+}
+
+const void *shared_acquire(const char *key, size_t keylen, const char **data, size_t *size)
+{
+    std::lock_guard guard(shared_mutex());
+    auto it = shared_data().find(std::string(key, keylen));
+    if (it == shared_data().end())
+        return nullptr;
+    auto d = it->second.lock();
+    if (!d)
+        return nullptr;
+    auto ref = new Data(std::move(d));
+    *data = (*ref)->data();
+    *size = (*ref)->size();
+    return ref;
+}
+
+void shared_release(const void *ref)
+{
+    // not called with shared_mutex held, as this might remove an entry
+    delete static_cast<const Data *>(ref);
+}
+
+const void *shared_publish(const char *key, size_t keylen, const char *data, size_t size)
+{
+    std::string k(key, keylen);
+    Data d(new std::string(data, size), [k](const std::string *s) {
+        delete s;
+        std::lock_guard guard(shared_mutex());
+        auto it = shared_data().find(k);
+        if (it != shared_data().end() && it->second.expired())
+            shared_data().erase(it);
+    });
+    {
+        std::lock_guard guard(shared_mutex());
+        shared_data()[k] = d;
+    }
+    return new Data(std::move(d));
+}
+
+// keep library instance providing cache loaded for the lifetime of the process, returns false if not possible
+bool pin_provider(const covconfig_shared_cache_v1 *cache)
+{
+#ifdef _WIN32
+    return cache->acquire == shared_acquire;
+#else
+    Dl_info own, provider;
+    if (!dladdr(reinterpret_cast<void *>(shared_acquire), &own) ||
+        !dladdr(reinterpret_cast<void *>(cache->acquire), &provider) || !provider.dli_fname)
+        return false;
+    if (own.dli_fbase == provider.dli_fbase)
+        return true;
+    // only references a library that is already loaded, never unloaded afterwards
+    return dlopen(provider.dli_fname, RTLD_LAZY | RTLD_NOLOAD | RTLD_NODELETE) != nullptr;
+#endif
+}
+
+} // namespace
+
+extern "C" COVCONFIG_SHARED_SYMBOL const covconfig_shared_cache_v1 *covconfig_get_shared_cache_v1()
+{
+    static const covconfig_shared_cache_v1 cache{1, sizeof(covconfig_shared_cache_v1), shared_acquire,
+                                                 shared_release, shared_publish};
+    return &cache;
+}
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+SharedCache::SharedCache()
+{
+    if (getenv("COVCONFIG_SHARED_CACHE")) {
+        auto cache = covconfig_get_shared_cache_v1();
+        if (cache && cache->version >= 1 && cache->size >= sizeof(covconfig_shared_cache_v1) && pin_provider(cache))
+            m_cache = cache;
+    }
+}
+
+bool SharedCache::enabled() const
+{
+    return m_cache != nullptr;
+}
+
+SharedCache::Reference SharedCache::use(const std::string &key,
+                                        const std::function<void(std::string_view data)> &func) const
+{
+    if (!m_cache)
+        return nullptr;
+    const char *data = nullptr;
+    size_t size = 0;
+    auto ref = m_cache->acquire(key.data(), key.size(), &data, &size);
+    if (!ref)
+        return nullptr;
+    Reference reference(ref, [cache = m_cache](const void *r) { cache->release(r); });
+    func(std::string_view(data, size));
+    return reference;
+}
+
+SharedCache::Reference SharedCache::publish(const std::string &key, std::string_view data) const
+{
+    if (!m_cache)
+        return nullptr;
+    auto ref = m_cache->publish(key.data(), key.size(), data.data(), data.size());
+    if (!ref)
+        return nullptr;
+    return Reference(ref, [cache = m_cache](const void *r) { cache->release(r); });
+}
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -0,0 +1,58 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file sharedcache.h
+/// snapshots of parsed files shared by all instances of the library within a process
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+extern "C" {
+/// version 1 of the interface between library instances built with different CONFIG_NAMESPACEs
+/** layout must never change, extensions require a new version or may only be appended and detected via size */
+struct covconfig_shared_cache_v1 {
+    unsigned version; ///< 1
+    size_t size; ///< sizeof the structure as defined by the providing library instance
+    /// lookup data stored for key, returns reference to be passed to release or null if not found
+    const void *(*acquire)(const char *key, size_t keylen, const char **data, size_t *size);
+    void (*release)(const void *ref); ///< release reference obtained from acquire or publish
+    /// replace data for key, returns reference to be passed to release
+    const void *(*publish)(const char *key, size_t keylen, const char *data, size_t size);
+};
+}
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+/// process-wide store of binary tree snapshots, independent of CONFIG_NAMESPACE
+/** All instances of the library use the implementation of `covconfig_shared_cache_v1` that is found first
+    by the dynamic linker, which requires symbol interposition, i.e. it is not available on Windows.
+    The library instance providing it is pinned in memory, so that it stays valid when that instance is unloaded.
+    Data is removed from the cache once the last \ref Reference to it has been destroyed. */
+class SharedCache {
+public:
+    typedef std::shared_ptr<const void> Reference; ///< keeps data alive within the cache
+
+    SharedCache();
+    bool enabled() const;
+    Reference use(const std::string &key,
+                  const std::function<void(std::string_view data)> &func) const; ///< call func with data, if found
+    Reference publish(const std::string &key, std::string_view data) const; ///< replace data for key
+
+private:
+    const covconfig_shared_cache_v1 *m_cache = nullptr;
+};
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
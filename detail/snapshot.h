@@ -0,0 +1,73 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file snapshot.h
+/// copy of an entry's value that may be read while another thread assigns
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+/// published value of type V, readers never wait for locks held by Manager or Config
+/** arithmetic types are stored in a std::atomic, so that reading is wait-free */
+template<class V, bool Atomic = std::is_arithmetic<V>::value>
+class Snapshot {
+public:
+    void store(const V &value) { m_value.store(value, std::memory_order_release); }
+    V load() const { return m_value.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<V> m_value{V()};
+};
+
+/// published value of type V, readers never wait for locks held by Manager or Config
+/** other types are published as immutable copies, which are freed once the last reader has released them */
+template<class V>
+class Snapshot<V, false> {
+public:
+#ifdef __cpp_lib_atomic_shared_ptr
+    void store(const V &value) { m_value.store(std::make_shared<const V>(value), std::memory_order_release); }
+    std::shared_ptr<const V> pointer() const { return m_value.load(std::memory_order_acquire); }
+#else
+    // only held for exchanging the pointer, copies are made without holding it
+    void store(const V &value)
+    {
+        auto copy = std::make_shared<const V>(value);
+        std::lock_guard guard(m_mutex);
+        m_value.swap(copy);
+    }
+    std::shared_ptr<const V> pointer() const
+    {
+        std::lock_guard guard(m_mutex);
+        return m_value;
+    }
+#endif
+    V load() const
+    {
+        auto value = pointer();
+        return value ? *value : V();
+    }
+
+private:
+#ifdef __cpp_lib_atomic_shared_ptr
+    std::atomic<std::shared_ptr<const V>> m_value;
+#else
+    mutable std::mutex m_mutex;
+    std::shared_ptr<const V> m_value;
+#endif
+};
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -8,6 +8,7 @@
 #include "toml/toml.hpp"
 
 #include <cassert>
+#include <charconv>
 #include <iostream>
 
 #ifdef CONFIG_NAMESPACE
@@ -17,124 +18,253 @@ namespace CONFIG_NAMESPACE {
 namespace config {
 namespace detail {
 
-toml::node *node_for_path(const Logger &logger, toml::table &root, const std::string &path, bool create)
+namespace {
+
+// parse `array[index]` into its components, returns false if there is no valid index
+bool split_index(std::string_view name, std::string_view &array, size_t &index)
 {
-    if (path.empty()) {
-        return &root;
-    }
+    auto bracket = name.find('[');
+    if (bracket == std::string_view::npos || name.back() != ']')
+        return false;
+    auto digits = name.substr(bracket + 1, name.size() - bracket - 2);
+    auto result = std::from_chars(digits.data(), digits.data() + digits.size(), index);
+    if (result.ec != std::errc() || result.ptr != digits.data() + digits.size())
+        return false;
+    array = name.substr(0, bracket);
+    return true;
+}
 
-    auto dot = path.find('.');
-    if (dot == std::string::npos) {
-        auto bracket = path.find('[');
-        if (bracket != std::string::npos) {
-            if (path.back() != ']') {
-                logger.error("-> node_for_path") << "invalid section name " << path << std::endl;
+// create all tables along a dotted path, registering them with the index
+toml::table *create_path(const Logger &logger, IndexedTable &tree, const std::string &path)
+{
+    toml::table *parent = &tree.root();
+    size_t begin = 0;
+    for (;;) {
+        auto dot = path.find('.', begin);
+        if (dot == std::string::npos)
+            dot = path.size();
+        const auto prefix = path.substr(0, dot);
+        const auto component = std::string_view(path).substr(begin, dot - begin);
+        auto node = tree.find(prefix);
+        if (!node && component.find('[') != std::string_view::npos) {
+            std::string_view array;
+            size_t idx = 0;
+            if (!split_index(component, array, idx)) {
+                logger.error("-> create_path") << "invalid section name " << prefix << std::endl;
                 return nullptr;
             }
-            auto index = path.substr(bracket + 1, path.size() - bracket - 2);
-            auto array = path.substr(0, bracket);
-            auto node = root[array];
-            if (!node) {
-                if (!create)
-                    return nullptr;
-                root.insert(array, toml::array());
-                node = root[array];
+            const auto arrayKey = path.substr(0, begin + array.size());
+            auto anode = tree.find(arrayKey);
+            if (!anode) {
+                anode = tree.assign(*parent, arrayKey.substr(0, begin ? begin - 1 : 0), std::string(array),
+                                    toml::array());
             }
-            auto arr = node.as_array();
+            auto arr = anode->as_array();
             if (!arr) {
-                logger.error("-> node_for_path")
-                    << "expected array for section " << array << " in table " << root << std::endl;
+                logger.error("-> create_path") << "expected array for section " << arrayKey << std::endl;
                 return nullptr;
             }
-            auto idx = std::stoul(index);
-            if (idx < 0) {
-                logger.error("-> node_for_path")
-                    << "negative index " << idx << " for array " << array << " in table " << root << std::endl;
-                return nullptr;
+            for (size_t i = arr->size(); i <= idx; ++i) {
+                arr->push_back(toml::table());
+                tree.add(IndexedTable::element_key(arrayKey, i), &(*arr)[i]);
             }
-            if (idx >= arr->size()) {
-                if (!create) {
-                    logger.error("-> node_for_path")
-                        << "index " << idx << " out of bounds for array " << array << " in table " << root << std::endl;
-                    return nullptr;
-                }
-                arr->resize(idx + 1, toml::table());
-            }
-
-            return (*arr)[idx].as_table();
-        }
-
-        if (auto node = root[path]) {
-            if (!node.as_table()) {
-                logger.error("-> node_for_path") << "already have " << path << " in table " << root << std::endl;
+            node = &(*arr)[idx];
+        } else if (!node) {
+            auto result = parent->insert(component, toml::table());
+            if (!result.second) {
+                logger.error("-> create_path") << "could not insert section " << prefix << std::endl;
+                return nullptr;
             }
-            return node.as_table();
+            node = &result.first->second;
+            tree.add(prefix, node);
         }
-        if (!create) {
+        parent = node->as_table();
+        if (!parent) {
+            logger.error("-> create_path") << "expected table for section " << prefix << std::endl;
             return nullptr;
         }
-        auto result = root.insert(path, toml::table());
-        if (!result.second) {
-            logger.error("-> node_for_path")
-                << "could not insert section " << path << " into table " << root << std::endl;
-            return nullptr;
-        }
-        //return result.first->as_table();
-        return root[path].as_table();
+        if (dot == path.size())
+            return parent;
+        begin = dot + 1;
     }
+}
 
-    auto pre = path.substr(0, dot);
-    auto parent = node_for_path(logger, root, pre, create);
-    if (!parent) {
-        return nullptr;
+void remove_descendants(std::unordered_map<std::string, toml::node *> &nodes, const std::string &key,
+                        toml::node *node)
+{
+    if (auto tbl = node->as_table()) {
+        for (auto &&[name, child]: *tbl) {
+            auto k = IndexedTable::child_key(key, name.str());
+            remove_descendants(nodes, k, &child);
+            nodes.erase(k);
+        }
+    } else if (auto arr = node->as_array()) {
+        for (size_t i = 0; i < arr->size(); ++i) {
+            auto k = IndexedTable::element_key(key, i);
+            remove_descendants(nodes, k, &(*arr)[i]);
+            nodes.erase(k);
+        }
     }
-    if (!parent->is_table()) {
-        logger.error("-> node_for_path") << "expected table for section " << pre << " in table " << root << std::endl;
+}
+
+} // namespace
+
+IndexedTable::IndexedTable()
+{
+    reindex();
+}
+
+void IndexedTable::reset(toml::table &&root)
+{
+    m_root = std::move(root);
+    reindex();
+}
+
+void IndexedTable::reindex()
+{
+    m_nodes.clear();
+    add(std::string(), &m_root);
+}
+
+toml::table &IndexedTable::root()
+{
+    return m_root;
+}
+
+const toml::table &IndexedTable::root() const
+{
+    return m_root;
+}
+
+toml::node *IndexedTable::find(const std::string &key) const
+{
+    auto it = m_nodes.find(key);
+    if (it == m_nodes.end())
         return nullptr;
+    return it->second;
+}
+
+void IndexedTable::add(const std::string &key, toml::node *node)
+{
+    m_nodes[key] = node;
+    if (auto tbl = node->as_table()) {
+        for (auto &&[name, child]: *tbl) {
+            add(child_key(key, name.str()), &child);
+        }
+    } else if (auto arr = node->as_array()) {
+        for (size_t i = 0; i < arr->size(); ++i) {
+            add(element_key(key, i), &(*arr)[i]);
+        }
     }
-    auto ptbl = parent->as_table();
-    const auto post = path.substr(dot + 1);
-    return node_for_path(logger, *ptbl, post, create);
 }
 
-toml::table *table_for_section(const Logger &logger, toml::table &root, const std::string &section, bool create)
+void IndexedTable::remove(const std::string &key)
+{
+    auto it = m_nodes.find(key);
+    if (it == m_nodes.end())
+        return;
+    remove_descendants(m_nodes, key, it->second);
+    m_nodes.erase(key);
+}
+
+bool IndexedTable::erase(toml::table &parent, const std::string &parentKey, const std::string &name)
 {
-    logger.debug("-> table_for_section") << "looking for or creating section " << section << " in table " << root
-                                         << std::endl;
-    auto node = node_for_path(logger, root, section, create);
+    remove(child_key(parentKey, name));
+    return parent.erase(name) > 0;
+}
+
+std::string IndexedTable::child_key(const std::string &parentKey, std::string_view name)
+{
+    std::string key = parentKey;
+    if (!key.empty())
+        key += ".";
+    key += name;
+    return key;
+}
+
+std::string IndexedTable::element_key(const std::string &arrayKey, size_t index)
+{
+    return arrayKey + "[" + std::to_string(index) + "]";
+}
+
+toml::table *table_for_section(const Logger &logger, IndexedTable &tree, const std::string &section, bool create)
+{
+    CONFIG_DEBUG_FOR(logger, "-> table_for_section")
+        << "looking for or creating section " << section << " in table " << tree.root() << std::endl;
+    auto node = tree.find(section);
     if (!node) {
-        logger.debug("-> table_for_section")
-            << "looked for section " << section << " in table " << root << ", not found and not created" << std::endl;
+        if (create) {
+            return create_path(logger, tree, section);
+        }
+        CONFIG_DEBUG_FOR(logger, "-> table_for_section")
+            << "looked for section " << section << ", not found and not created" << std::endl;
         return nullptr;
     }
     if (auto tbl = node->as_table()) {
-        logger.debug("-> table_for_section")
-            << "looked for section " << section << " in table " << root << ", found" << *tbl << std::endl;
+        CONFIG_DEBUG_FOR(logger, "-> table_for_section") << "looked for section " << section << ", found" << *tbl
+                                                         << std::endl;
         return tbl;
     }
-    logger.debug("-> table_for_section") << "looked for section " << section << " in table " << root
-                                         << ", found not a table" << std::endl;
+    CONFIG_DEBUG_FOR(logger, "-> table_for_section") << "looked for section " << section << ", found not a table"
+                                                     << std::endl;
     return nullptr;
 }
 
-const toml::table *table_for_section(const Logger &logger, const toml::table &root, const std::string &section)
+const toml::table *table_for_section(const Logger &logger, const IndexedTable &tree, const std::string &section)
 {
-    auto node = node_for_path(logger, const_cast<toml::table &>(root), section, false);
+    auto node = tree.find(section);
     if (!node) {
-        logger.debug("-> table_for_section")
-            << "looked for section " << section << " in table " << root << ", not found" << std::endl;
+        CONFIG_DEBUG_FOR(logger, "-> table_for_section") << "looked for section " << section << ", not found"
+                                                         << std::endl;
         return nullptr;
     }
     if (auto tbl = node->as_table()) {
-        logger.debug("-> table_for_section")
-            << "looked for section " << section << " in table " << root << ", found" << *tbl << std::endl;
+        CONFIG_DEBUG_FOR(logger, "-> table_for_section") << "looked for section " << section << ", found" << *tbl
+                                                         << std::endl;
         return tbl;
     }
-    logger.debug("-> table_for_section") << "looked for section " << section << " in table " << root
-                                         << ", found not a table" << std::endl;
+    CONFIG_DEBUG_FOR(logger, "-> table_for_section") << "looked for section " << section << ", found not a table"
+                                                     << std::endl;
     return nullptr;
 }
 
+// locate `name` within tbl, where name may also refer to an array member as `array[index]`
+const toml::node *node_for_name(Entry *entry, const toml::table *tbl, std::string_view name, bool optional)
+{
+    if (name.find('[') == std::string_view::npos) {
+        auto node = tbl->get(name);
+        if (!node) {
+            CONFIG_DEBUG_FOR(*entry, "get_from_table") << "node for name " << name << " not found" << std::endl;
+        }
+        return node;
+    }
+
+    std::string_view array;
+    size_t idx = 0;
+    if (!split_index(name, array, idx)) {
+        entry->error("get_from_table") << "invalid name " << name << std::endl;
+        return nullptr;
+    }
+    CONFIG_DEBUG_FOR(*entry, "get_from_table") << "name " << name << " accesses an array: array=" << array
+                                               << ", index=" << idx << std::endl;
+    auto arr = tbl->get(array);
+    if (!arr) {
+        (optional ? entry->debug("get_from_table") : entry->error("get_from_table"))
+            << "node for array " << array << " not found" << std::endl;
+        return nullptr;
+    }
+    auto a = arr->as_array();
+    if (!a) {
+        entry->error("get_from_table") << "node " << array << " is not an array" << std::endl;
+        return nullptr;
+    }
+    if (idx >= a->size()) {
+        (optional ? entry->debug("get_from_table") : entry->error("get_from_table"))
+            << "index " << idx << " out of bounds for array " << array << std::endl;
+        return nullptr;
+    }
+    return &(*a)[idx];
+}
 
 template<class V>
 typename Convert<V>::TomlType Convert<V>::to_toml(Entry *entry, const V &v)
@@ -144,50 +274,16 @@ typename Convert<V>::TomlType Convert<V>::to_toml(Entry *entry, const V &v)
 
 template<class V>
 std::optional<typename Convert<V>::Type> Convert<V>::get_from_table(Entry *entry, const toml::table *tbl,
-                                                                    const std::string &name, bool optional)
+                                                                    std::string_view name, bool optional)
 {
     if (!tbl) {
         return std::optional<Type>();
     }
-    auto bracket = name.find('[');
-    if (bracket != std::string::npos) {
-        if (name.back() != ']') {
-            entry->error("get_from_table") << "invalid name " << name << std::endl;
-            return std::optional<Type>();
-        }
-        auto index = name.substr(bracket + 1, name.size() - bracket - 2);
-        auto array = name.substr(0, bracket);
-        entry->debug("get_from_table") << "name " << name << " accesses an array: array=" << array
-                                       << ", index=" << std::stoul(index) << std::endl;
-        auto arr = (*tbl)[array];
-        if (!arr) {
-            (optional ? entry->debug("get_from_table") : entry->error("get_from_table"))
-                << "node for array " << array << " not found" << std::endl;
-            return std::optional<Type>();
-        }
-        if (!arr.is_array()) {
-            entry->error("get_from_table") << "node " << array << " is not an array" << std::endl;
-            return std::optional<Type>();
-        }
-        auto a = arr.as_array();
-        auto idx = std::stoul(index);
-        if (idx >= a->size()) {
-            (optional ? entry->debug("get_from_table") : entry->error("get_from_table"))
-                << "index " << idx << " out of bounds for array " << array << std::endl;
-            return std::optional<Type>();
-        }
-        auto &node = a->at(std::stoul(index));
-        auto opt = node.template value<Type>();
-        if (!opt) {
-            entry->warn() << entry->key() << ": array not convertible to requested type" << std::endl;
-        }
-    }
-    auto node = (*tbl)[name];
+    auto node = node_for_name(entry, tbl, name, optional);
     if (!node) {
-        entry->debug() << "node for name " << name << " not found" << std::endl;
         return std::optional<Type>();
     }
-    auto opt = node.template value<Type>();
+    auto opt = node->template value<Type>();
     if (!opt) {
         entry->warn() << entry->key() << ": array not convertible to requested type" << std::endl;
     }
@@ -215,7 +311,7 @@ typename Convert<Section>::TomlType Convert<Section>::to_toml(Entry *entry, cons
 }
 
 std::optional<typename Convert<Section>::Type> Convert<Section>::get_from_table(Entry *entry, const toml::table *tbl,
-                                                                                const std::string &name, bool optional)
+                                                                                std::string_view name, bool optional)
 {
     if (!tbl) {
         return std::optional<Type>();
@@ -226,50 +322,12 @@ std::optional<typename Convert<Section>::Type> Convert<Section>::get_from_table(
         section += ".";
     section += name;
 
-    auto bracket = name.find('[');
-    if (bracket != std::string::npos) {
-        if (name.back() != ']') {
-            entry->error("get_from_table") << "invalid name " << name << std::endl;
-            return std::optional<Type>();
-        }
-        auto index = name.substr(bracket + 1, name.size() - bracket - 2);
-        auto array = name.substr(0, bracket);
-        entry->debug("get_from_table") << "name " << name << " accesses an array: array=" << array
-                                       << ", index=" << std::stoul(index) << std::endl;
-        auto arr = (*tbl)[array];
-        if (!arr) {
-            (optional ? entry->debug("get_from_table") : entry->error("get_from_table"))
-                << "node for array " << array << " not found" << std::endl;
-            return std::optional<Type>();
-        }
-        if (!arr.is_array()) {
-            entry->error("get_from_table") << "node " << array << " is not an array" << std::endl;
-            return std::optional<Type>();
-        }
-        auto a = arr.as_array();
-        auto idx = std::stoul(index);
-        if (idx >= a->size()) {
-            (optional ? entry->debug("get_from_table") : entry->error("get_from_table"))
-                << "index " << idx << " out of bounds for array " << array << std::endl;
-            return std::optional<Type>();
-        }
-        auto &node = a->at(std::stoul(index));
-        auto sec = config::Section(entry->path(), section);
-        sec.setTomlTable(node.as_table());
-        auto opt = std::optional<Type>(sec);
-        if (!opt) {
-            entry->warn() << entry->key() << ": array not convertible to requested type" << std::endl;
-        }
-        return opt;
-    }
-    auto node = (*tbl)[name];
+    auto node = node_for_name(entry, tbl, name, optional);
     if (!node) {
         return std::optional<Type>();
     }
-    auto sec = config::Section(entry->path(), section);
-    sec.setTomlTable(node.as_table());
-    auto opt = std::optional<Type>(sec);
-    return opt;
+    // lock on configuration is already held by caller
+    return std::optional<Type>(config::Section(entry->manager(), entry->config(), section, node->as_table()));
 }
 
 const std::optional<typename Convert<Section>::Type> Convert<Section>::as(Entry *entry, size_t index,
@@ -286,9 +344,7 @@ const std::optional<typename Convert<Section>::Type> Convert<Section>::as(Entry
         entry->warn() << entry->key() << ": expected table for section" << std::endl;
         return std::optional<config::Section>();
     }
-    config::Section sec(entry->path(), section);
-    sec.setTomlTable(tbl);
-    return std::optional<config::Section>(sec);
+    return std::optional<config::Section>(config::Section(entry->manager(), entry->config(), section, tbl));
 }
 
 template struct Convert<bool>;
@@ -7,6 +7,9 @@
 #pragma once
 
 #include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
 #include "toml/toml.hpp"
 #include "../section.h"
 
@@ -22,9 +25,75 @@ namespace detail {
 
 class Logger;
 
-toml::table *table_for_section(const Logger &logger, toml::table &root, const std::string &section,
+/// TOML table together with a flat index of all contained nodes by their full dotted key
+/** Members of arrays are indexed as `name[idx]`, the root table itself has the empty key.
+    All modifications have to be done via \ref assign and \ref erase or be followed by \ref reindex. */
+class IndexedTable {
+public:
+    IndexedTable();
+    IndexedTable(const IndexedTable &) = delete;
+    IndexedTable &operator=(const IndexedTable &) = delete;
+
+    void reset(toml::table &&root); ///< replace all contents
+    void reindex(); ///< rebuild index after modifications that bypassed it
+    toml::table &root();
+    const toml::table &root() const;
+
+    toml::node *find(const std::string &key) const; ///< node for a full dotted key
+    void add(const std::string &key, toml::node *node); ///< index node and all its descendants
+    void remove(const std::string &key); ///< drop node and all its descendants from the index
+
+    template<class T>
+    toml::node *assign(toml::table &parent, const std::string &parentKey, const std::string &name, T &&value);
+    template<class T>
+    bool update(toml::table &parent, const std::string &parentKey, const std::string &name,
+                T &&value); ///< assign unless equal value is stored already, returns whether contents changed
+    bool erase(toml::table &parent, const std::string &parentKey, const std::string &name);
+
+    static std::string child_key(const std::string &parentKey, std::string_view name);
+    static std::string element_key(const std::string &arrayKey, size_t index);
+
+private:
+    toml::table m_root;
+    std::unordered_map<std::string, toml::node *> m_nodes;
+};
+
+template<class T>
+toml::node *IndexedTable::assign(toml::table &parent, const std::string &parentKey, const std::string &name,
+                                 T &&value)
+{
+    auto key = child_key(parentKey, name);
+    remove(key);
+    auto result = parent.insert_or_assign(name, std::forward<T>(value));
+    toml::node *node = &result.first->second;
+    add(key, node);
+    return node;
+}
+
+template<class T>
+bool IndexedTable::update(toml::table &parent, const std::string &parentKey, const std::string &name, T &&value)
+{
+    if (auto node = parent.get(name)) {
+        typedef std::decay_t<T> V;
+        auto old = node->as<V>();
+        if (old && *old == value)
+            return false;
+        // numbers are equal independent of whether they are stored as integer or floating point
+        if constexpr (std::is_same_v<V, double>) {
+            if (auto i = node->as<int64_t>(); i && double(i->get()) == value)
+                return false;
+        } else if constexpr (std::is_same_v<V, int64_t>) {
+            if (auto d = node->as<double>(); d && d->get() == double(value))
+                return false;
+        }
+    }
+    assign(parent, parentKey, name, std::forward<T>(value));
+    return true;
+}
+
+toml::table *table_for_section(const Logger &logger, IndexedTable &tree, const std::string &section,
                                bool create = false);
-const toml::table *table_for_section(const Logger &logger, const toml::table &root, const std::string &section);
+const toml::table *table_for_section(const Logger &logger, const IndexedTable &tree, const std::string &section);
 
 class Entry;
 
@@ -34,7 +103,7 @@ struct Convert {
     typedef V TomlType;
 
     static TomlType to_toml(Entry *entry, const V &v);
-    static std::optional<Type> get_from_table(Entry *entry, const toml::table *tbl, const std::string &name,
+    static std::optional<Type> get_from_table(Entry *entry, const toml::table *tbl, std::string_view name,
                                               bool optional = false);
     static std::optional<Type> as(Entry *entry, size_t index, const toml::node &n);
 };
@@ -50,7 +119,7 @@ struct Convert<Section> {
     typedef toml::table TomlType;
 
     static TomlType to_toml(Entry *entry, const Type &v);
-    static std::optional<Type> get_from_table(Entry *entry, const toml::table *tbl, const std::string &name,
+    static std::optional<Type> get_from_table(Entry *entry, const toml::table *tbl, std::string_view name,
                                               bool optional = false);
     static const std::optional<Type> as(Entry *entry, size_t index, const toml::node &n);
 };
@@ -0,0 +1,637 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "treecache.h"
+#include "hash.h"
+#include "mappedfile.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <atomic>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char Magic[8] = {'C', 'O', 'V', 'C', 'T', 'R', 'E', 'E'};
+const uint32_t Version = 1;
+const uint32_t ByteOrder = 0x01020304;
+
+enum class NodeType : uint8_t {
+    Table = 1,
+    Array = 2,
+    String = 3,
+    Integer = 4,
+    Double = 5,
+    Bool = 6,
+};
+
+bool stat_source(const std::string &pathname, std::string_view contents, TreeSource &src)
+{
+    std::error_code ec;
+    auto mtime = fs::last_write_time(pathname, ec);
+    if (ec)
+        return false;
+    src.pathname = pathname;
+    src.size = contents.size();
+    src.mtime = mtime.time_since_epoch().count();
+    src.contents = contents;
+    return true;
+}
+
+class Writer {
+public:
+    template<class T>
+    void put(const T &v)
+    {
+        m_buf.append(reinterpret_cast<const char *>(&v), sizeof(v));
+    }
+    void put(std::string_view s)
+    {
+        put(uint32_t(s.size()));
+        m_buf.append(s.data(), s.size());
+    }
+    // returns false for node types that cannot be stored
+    bool put(const toml::node &node)
+    {
+        if (auto tbl = node.as_table()) {
+            put(NodeType::Table);
+            put(uint32_t(tbl->size()));
+            for (auto &&[key, child]: *tbl) {
+                put(key.str());
+                if (!put(child))
+                    return false;
+            }
+        } else if (auto arr = node.as_array()) {
+            put(NodeType::Array);
+            put(uint32_t(arr->size()));
+            for (size_t i = 0; i < arr->size(); ++i) {
+                if (!put((*arr)[i]))
+                    return false;
+            }
+        } else if (auto s = node.as<std::string>()) {
+            put(NodeType::String);
+            put(std::string_view(s->get()));
+        } else if (auto i = node.as<int64_t>()) {
+            put(NodeType::Integer);
+            put(i->get());
+        } else if (auto d = node.as<double>()) {
+            put(NodeType::Double);
+            put(d->get());
+        } else if (auto b = node.as<bool>()) {
+            put(NodeType::Bool);
+            put(uint8_t(b->get()));
+        } else {
+            // dates and times are not supported
+            return false;
+        }
+        return true;
+    }
+    const std::string &buffer() const { return m_buf; }
+
+private:
+    std::string m_buf;
+};
+
+class Reader {
+public:
+    explicit Reader(std::string_view data): m_data(data) {}
+
+    template<class T>
+    bool get(T &v)
+    {
+        if (m_data.size() - m_pos < sizeof(v))
+            return false;
+        memcpy(&v, m_data.data() + m_pos, sizeof(v));
+        m_pos += sizeof(v);
+        return true;
+    }
+    bool get(std::string_view &s)
+    {
+        uint32_t len = 0;
+        if (!get(len) || m_data.size() - m_pos < len)
+            return false;
+        s = m_data.substr(m_pos, len);
+        m_pos += len;
+        return true;
+    }
+    bool getTable(toml::table &tbl)
+    {
+        uint32_t count = 0;
+        if (!get(count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            std::string_view key;
+            if (!get(key) || !getNode([&tbl, key](auto &&value) { tbl.insert(key, std::move(value)); }))
+                return false;
+        }
+        return true;
+    }
+    bool getArray(toml::array &arr)
+    {
+        uint32_t count = 0;
+        if (!get(count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (!getNode([&arr](auto &&value) { arr.push_back(std::move(value)); }))
+                return false;
+        }
+        return true;
+    }
+    // read a node and pass it to add
+    template<class Add>
+    bool getNode(Add add)
+    {
+        NodeType type;
+        if (!get(type))
+            return false;
+        switch (type) {
+        case NodeType::Table: {
+            toml::table tbl;
+            if (!getTable(tbl))
+                return false;
+            add(std::move(tbl));
+            return true;
+        }
+        case NodeType::Array: {
+            toml::array arr;
+            if (!getArray(arr))
+                return false;
+            add(std::move(arr));
+            return true;
+        }
+        case NodeType::String: {
+            std::string_view s;
+            if (!get(s))
+                return false;
+            add(std::string(s));
+            return true;
+        }
+        case NodeType::Integer: {
+            int64_t i = 0;
+            if (!get(i))
+                return false;
+            add(i);
+            return true;
+        }
+        case NodeType::Double: {
+            double d = 0.;
+            if (!get(d))
+                return false;
+            add(d);
+            return true;
+        }
+        case NodeType::Bool: {
+            uint8_t b = 0;
+            if (!get(b))
+                return false;
+            add(b != 0);
+            return true;
+        }
+        }
+        return false;
+    }
+    bool atEnd() const { return m_pos == m_data.size(); }
+
+private:
+    std::string_view m_data;
+    size_t m_pos = 0;
+};
+
+enum class Status {
+    Ok,
+    Invalid,
+    Stale,
+    Corrupt,
+};
+
+// serialize tree of parsed file src, returns false if it contains unsupported data types
+bool encode(const TreeSource &src, const toml::table &tbl, std::string &buf)
+{
+    Writer writer;
+    writer.put(Magic);
+    writer.put(Version);
+    writer.put(ByteOrder);
+    writer.put(std::string_view(src.pathname));
+    writer.put(src.size);
+    writer.put(src.mtime);
+    writer.put(fnv1a(src.contents));
+    writer.put(uint32_t(tbl.size()));
+    for (auto &&[key, child]: tbl) {
+        writer.put(key.str());
+        if (!writer.put(child))
+            return false;
+    }
+    buf = writer.buffer();
+    return true;
+}
+
+// check whether snapshot read by reader was created from src
+Status decodeHeader(Reader &reader, const TreeSource &src)
+{
+    char magic[sizeof(Magic)];
+    uint32_t version = 0, order = 0;
+    TreeSource cached;
+    uint64_t hash = 0;
+    std::string_view path;
+    if (!reader.get(magic) || memcmp(magic, Magic, sizeof(Magic)) != 0 || !reader.get(version) ||
+        version != Version || !reader.get(order) || order != ByteOrder || !reader.get(path) ||
+        !reader.get(cached.size) || !reader.get(cached.mtime) || !reader.get(hash))
+        return Status::Invalid;
+    if (path != src.pathname || cached.size != src.size || cached.mtime != src.mtime)
+        return Status::Stale;
+    // only hashed when cheaper checks pass, catches changes within granularity of modification time
+    if (hash != fnv1a(src.contents))
+        return Status::Stale;
+    return Status::Ok;
+}
+
+Status decode(std::string_view data, const TreeSource &src, toml::table &tbl)
+{
+    Reader reader(data);
+    auto status = decodeHeader(reader, src);
+    if (status != Status::Ok)
+        return status;
+    if (!reader.getTable(tbl) || !reader.atEnd())
+        return Status::Corrupt;
+    return Status::Ok;
+}
+
+// decoded snapshot, shared by all managers of this library instance as long as one of them uses it
+struct DecodedTree {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    uint64_t hash = 0;
+    toml::table tbl;
+    SharedCache::Reference data; // keeps serialized snapshot available to other library instances
+};
+
+// never destroyed, as references might be released during exit
+std::mutex &decoded_mutex()
+{
+    static auto mutex = new std::mutex;
+    return *mutex;
+}
+
+std::map<std::string, std::weak_ptr<const DecodedTree>> &decoded_trees()
+{
+    static auto trees = new std::map<std::string, std::weak_ptr<const DecodedTree>>;
+    return *trees;
+}
+
+std::shared_ptr<const DecodedTree> find_decoded(const TreeSource &src)
+{
+    std::shared_ptr<const DecodedTree> tree;
+    {
+        std::lock_guard guard(decoded_mutex());
+        auto it = decoded_trees().find(src.pathname);
+        if (it == decoded_trees().end())
+            return nullptr;
+        tree = it->second.lock();
+    }
+    if (!tree || tree->size != src.size || tree->mtime != src.mtime || tree->hash != fnv1a(src.contents))
+        return nullptr;
+    return tree;
+}
+
+std::shared_ptr<const DecodedTree> share_decoded(const TreeSource &src, toml::table tbl, SharedCache::Reference data)
+{
+    auto tree = std::make_shared<DecodedTree>();
+    tree->size = src.size;
+    tree->mtime = src.mtime;
+    tree->hash = fnv1a(src.contents);
+    tree->tbl = std::move(tbl);
+    tree->data = std::move(data);
+
+    std::lock_guard guard(decoded_mutex());
+    auto &trees = decoded_trees();
+    for (auto it = trees.begin(); it != trees.end();) {
+        if (it->second.expired())
+            it = trees.erase(it);
+        else
+            ++it;
+    }
+    trees[src.pathname] = tree;
+    return tree;
+}
+
+} // namespace
+
+TreeCache::TreeCache(): Logger("TreeCache")
+{
+#ifdef CONFIG_NAME
+    m_name = CONFIG_NAME;
+#else
+    m_name = "covconfig";
+#endif
+
+#ifndef _WIN32
+    if (const char *shm = getenv("COVCONFIG_SHM")) {
+        m_shared = true;
+        m_unlinkOnExit = strcmp(shm, "unlink") == 0;
+        CONFIG_DEBUG() << "sharing parsed configuration in node-local shared memory"
+                       << (m_unlinkOnExit ? ", removed on exit" : "") << std::endl;
+    }
+#endif
+
+    const char *dir = getenv("COVCONFIG_CACHE");
+    if (!dir)
+        return;
+    if (*dir) {
+        m_dir = dir;
+    } else if (const char *xdg_cache = getenv("XDG_CACHE_HOME")) {
+        m_dir = std::string(xdg_cache) + "/" + m_name;
+    } else if (const char *home = getenv("HOME")) {
+        m_dir = std::string(home) + "/.cache/" + m_name;
+    } else if (const char *appdata = getenv("LOCALAPPDATA")) {
+        m_dir = std::string(appdata) + "/" + m_name + "/cache";
+    }
+    CONFIG_DEBUG() << "caching parsed configuration in " << m_dir << std::endl;
+}
+
+TreeCache::~TreeCache()
+{
+#ifndef _WIN32
+    std::lock_guard guard(m_mutex);
+    for (const auto &name: m_published) {
+        CONFIG_DEBUG("~TreeCache") << "removing shared snapshot " << name << std::endl;
+        shm_unlink(name.c_str());
+    }
+#endif
+}
+
+bool TreeCache::enabled() const
+{
+    return m_shared || m_instances.enabled() || !m_dir.empty();
+}
+
+std::string TreeCache::cacheFile(const std::string &pathname) const
+{
+    std::stringstream str;
+    str << m_dir << "/" << std::hex << fnv1a(pathname) << ".tree";
+    return str.str();
+}
+
+std::optional<toml::table> TreeCache::load(const std::string &pathname, std::string_view contents,
+                                           Reference &ref) const
+{
+    if (!enabled())
+        return std::nullopt;
+
+    TreeSource src;
+    if (!stat_source(pathname, contents, src))
+        return std::nullopt;
+
+    if (m_instances.enabled()) {
+        if (auto tree = find_decoded(src)) {
+            CONFIG_DEBUG("load") << "reusing decoded snapshot of " << pathname << std::endl;
+            ref = tree;
+            return tree->tbl;
+        }
+        toml::table tbl;
+        Status status = Status::Invalid;
+        auto decodeShared = [&src, &tbl, &status](std::string_view data) { status = decode(data, src, tbl); };
+        auto data = m_instances.use(pathname, decodeShared);
+        if (data && status == Status::Ok) {
+            CONFIG_DEBUG("load") << "loaded " << pathname << " from snapshot of another instance" << std::endl;
+            auto tree = share_decoded(src, std::move(tbl), std::move(data));
+            ref = tree;
+            return tree->tbl;
+        }
+    }
+    if (m_shared) {
+        if (auto tbl = loadShared(src))
+            return tbl;
+    }
+    if (m_dir.empty())
+        return std::nullopt;
+
+    const auto cachename = cacheFile(pathname);
+    MappedFile file(cachename);
+    if (!file.valid()) {
+        CONFIG_DEBUG("load") << "no snapshot for " << pathname << std::endl;
+        return std::nullopt;
+    }
+
+    toml::table tbl;
+    switch (decode(file.data(), src, tbl)) {
+    case Status::Ok:
+        break;
+    case Status::Invalid:
+        CONFIG_DEBUG("load") << "invalid snapshot " << cachename << " for " << pathname << std::endl;
+        return std::nullopt;
+    case Status::Stale:
+        CONFIG_DEBUG("load") << "stale snapshot " << cachename << " for " << pathname << std::endl;
+        return std::nullopt;
+    case Status::Corrupt:
+        warn("load") << "corrupt snapshot " << cachename << " for " << pathname << std::endl;
+        return std::nullopt;
+    }
+    CONFIG_DEBUG("load") << "loaded " << pathname << " from snapshot " << cachename << std::endl;
+    return tbl;
+}
+
+bool TreeCache::store(const std::string &pathname, std::string_view contents, const toml::table &tbl,
+                      Reference &ref) const
+{
+    if (!enabled())
+        return false;
+
+    TreeSource src;
+    if (!stat_source(pathname, contents, src))
+        return false;
+
+    std::string buf;
+    if (!encode(src, tbl, buf)) {
+        CONFIG_DEBUG("store") << "not storing snapshot of " << pathname << ": unsupported data type" << std::endl;
+        return false;
+    }
+
+    bool stored = false;
+    if (m_instances.enabled()) {
+        ref = share_decoded(src, tbl, m_instances.publish(pathname, buf));
+        stored = true;
+    }
+    if (m_shared && storeShared(src, buf))
+        stored = true;
+    if (m_dir.empty())
+        return stored;
+
+    std::error_code ec;
+    fs::create_directories(m_dir, ec);
+    const auto cachename = cacheFile(pathname);
+    // write to temporary file and rename, as other processes might read the snapshot concurrently
+    const auto temp = cachename + "." + std::to_string(std::random_device()()) + ".new";
+    {
+        std::ofstream f(temp, std::ios::binary);
+        f.write(buf.data(), buf.size());
+        if (!f) {
+            CONFIG_DEBUG("store") << "failed to write snapshot " << temp << std::endl;
+            f.close();
+            std::remove(temp.c_str());
+            return stored;
+        }
+    }
+    fs::rename(temp, cachename, ec);
+    if (ec) {
+        CONFIG_DEBUG("store") << "failed to rename snapshot to " << cachename << ": " << ec.message() << std::endl;
+        std::remove(temp.c_str());
+        return stored;
+    }
+    CONFIG_DEBUG("store") << "stored snapshot of " << pathname << " in " << cachename << std::endl;
+    return true;
+}
+
+std::string TreeCache::segmentName(const std::string &pathname) const
+{
+    // keyed by resolved file, private to user: a single segment per file, replaced when the file changes
+    std::stringstream str;
+    str << "/" << m_name << "-";
+#ifndef _WIN32
+    str << getuid() << "-";
+#endif
+    str << std::hex << fnv1a(pathname) << ".tree";
+    return str.str();
+}
+
+std::optional<toml::table> TreeCache::loadShared(const TreeSource &src) const
+{
+#ifdef _WIN32
+    return std::nullopt;
+#else
+    const auto name = segmentName(src.pathname);
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1) {
+        CONFIG_DEBUG("load") << "no shared snapshot for " << src.pathname << std::endl;
+        return std::nullopt;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size == 0) {
+        close(fd);
+        return std::nullopt;
+    }
+    void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return std::nullopt;
+
+    toml::table tbl;
+    auto status = decode(std::string_view(static_cast<const char *>(map), st.st_size), src, tbl);
+    munmap(map, st.st_size);
+    if (status == Status::Stale) {
+        // complete, but created from other contents: remove, so that it does not outlive changes to the file
+        CONFIG_DEBUG("load") << "removing stale shared snapshot " << name << " for " << src.pathname << std::endl;
+        shm_unlink(name.c_str());
+        return std::nullopt;
+    }
+    if (status != Status::Ok) {
+        // also while publisher has not yet completed writing
+        CONFIG_DEBUG("load") << "unusable shared snapshot " << name << " for " << src.pathname << std::endl;
+        return std::nullopt;
+    }
+    CONFIG_DEBUG("load") << "loaded " << src.pathname << " from shared snapshot " << name << std::endl;
+    return tbl;
+#endif
+}
+
+bool TreeCache::publishedShared(const std::string &name, const TreeSource &src) const
+{
+#ifdef _WIN32
+    return false;
+#else
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return false;
+    Reader reader(std::string_view(static_cast<const char *>(map), st.st_size));
+    const bool ok = decodeHeader(reader, src) == Status::Ok;
+    munmap(map, st.st_size);
+    return ok;
+#endif
+}
+
+bool TreeCache::storeShared(const TreeSource &src, const std::string &buf) const
+{
+#ifdef _WIN32
+    return false;
+#else
+    const auto name = segmentName(src.pathname);
+    // only the first process publishes a snapshot
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd == -1 && errno == EEXIST) {
+        if (publishedShared(name, src)) {
+            CONFIG_DEBUG("store") << "shared snapshot " << name << " already published" << std::endl;
+            return false;
+        }
+        // replace snapshot of outdated contents or left incomplete, e.g. by a crashed publisher
+        CONFIG_DEBUG("store") << "replacing shared snapshot " << name << std::endl;
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    }
+    if (fd == -1) {
+        CONFIG_DEBUG("store") << "not publishing shared snapshot " << name << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, buf.size()) == -1) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void *map = mmap(nullptr, buf.size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return false;
+    }
+    // write magic last, so that concurrent readers ignore incomplete snapshots
+    char *data = static_cast<char *>(map);
+    memcpy(data + sizeof(Magic), buf.data() + sizeof(Magic), buf.size() - sizeof(Magic));
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(data, buf.data(), sizeof(Magic));
+    munmap(map, buf.size());
+    if (m_unlinkOnExit) {
+        std::lock_guard guard(m_mutex);
+        m_published.push_back(name);
+    }
+    CONFIG_DEBUG("store") << "published shared snapshot of " << src.pathname << " as " << name << std::endl;
+    return true;
+#endif
+}
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -0,0 +1,78 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file treecache.h
+/// binary snapshots of parsed configuration files for skipping TOML parsing at startup
+#pragma once
+
+#include "logger.h"
+#include "sharedcache.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "toml/toml.hpp"
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+namespace detail {
+
+/// identification of the TOML file a snapshot was created from
+struct TreeSource {
+    std::string pathname;
+    uint64_t size = 0;
+    int64_t mtime = 0; // modification time
+    std::string_view contents; // hashed when size and modification time match those of a snapshot
+};
+
+/// store parsed configuration trees in a compact binary format
+/** Enabled by setting the environment variable `COVCONFIG_CACHE`, either to a directory or empty for the
+    default location within `XDG_CACHE_HOME`.
+    Setting `COVCONFIG_SHM` also publishes snapshots as node-local shared memory segments,
+    which are created by the first process parsing a file and mapped by all later ones,
+    setting it to `unlink` removes segments created by a process when its last \ref Access is destroyed.
+    Setting `COVCONFIG_SHARED_CACHE` keeps snapshots in memory for all library instances within the process,
+    decoded trees are shared by all managers of a library instance,
+    both are released when the last configuration referencing them is destroyed.
+    Snapshots are keyed by source path, size, modification time and content hash of the TOML file
+    and are ignored when stale, there is at most one shared memory segment per file. */
+class TreeCache: public Logger {
+public:
+    typedef std::shared_ptr<const void> Reference; ///< keeps snapshot shared within the process alive
+
+    TreeCache();
+    ~TreeCache(); ///< removes shared memory segments published by this instance, if requested
+    bool enabled() const;
+    std::optional<toml::table> load(const std::string &pathname, std::string_view contents, Reference &ref) const;
+    bool store(const std::string &pathname, std::string_view contents, const toml::table &tbl,
+               Reference &ref) const;
+
+private:
+    std::string cacheFile(const std::string &pathname) const;
+    std::string segmentName(const std::string &pathname) const;
+    std::optional<toml::table> loadShared(const TreeSource &src) const;
+    bool publishedShared(const std::string &name, const TreeSource &src) const; ///< complete snapshot of src exists
+    bool storeShared(const TreeSource &src, const std::string &buf) const;
+
+    std::string m_name; // for prefixing cache files and segments
+    std::string m_dir;
+    bool m_shared = false; // use shared memory segments
+    bool m_unlinkOnExit = false; // remove published segments on destruction
+    mutable std::mutex m_mutex; // guards m_published
+    mutable std::vector<std::string> m_published; // names of segments created by this instance
+    SharedCache m_instances; // snapshots shared with other library instances
+};
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -0,0 +1,68 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file typetag.h
+/// compile-time identification of configuration value types
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+
+class Section;
+
+namespace detail {
+
+/// type of data stored in a configuration entry
+enum class TypeTag : uint8_t {
+    Invalid = 0,
+    Bool = 1,
+    Integer = 2,
+    Double = 3,
+    String = 4,
+    Section = 5,
+    Array = 0x10, ///< flag marking an array of one of the types above
+};
+
+#ifndef DOXYGEN
+template<class V>
+struct ValueTypeTag;
+
+#define TYPE_TAG_DECL(V, T) \
+    template<> \
+    struct ValueTypeTag<V> { \
+        static constexpr TypeTag value = TypeTag::T; \
+    };
+
+TYPE_TAG_DECL(bool, Bool)
+TYPE_TAG_DECL(int64_t, Integer)
+TYPE_TAG_DECL(double, Double)
+TYPE_TAG_DECL(std::string, String)
+TYPE_TAG_DECL(config::Section, Section)
+#undef TYPE_TAG_DECL
+#endif
+
+/// tag for a single value of type V
+template<class V>
+constexpr TypeTag value_tag()
+{
+    return ValueTypeTag<V>::value;
+}
+
+/// tag for an array of values of type V
+template<class V>
+constexpr TypeTag array_tag()
+{
+    return TypeTag(uint8_t(ValueTypeTag<V>::value) | uint8_t(TypeTag::Array));
+}
+
+} // namespace detail
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
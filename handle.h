@@ -0,0 +1,71 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file handle.h
+/// compact references to configuration entries for repeated access
+#pragma once
+
+#include <cstdint>
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+
+class Access;
+
+namespace detail {
+
+/// index into the dense entry table of a Manager
+/** tagged with the generation of the Manager, so that handles outliving it are detected */
+class HandleBase {
+public:
+    bool valid() const { return m_id != Invalid; } ///< query whether handle refers to an entry
+    uint32_t id() const { return m_id; } ///< index of the entry within its Manager
+    uint32_t generation() const { return m_generation; } ///< identifies the Manager that resolved the handle
+
+protected:
+    static constexpr uint32_t Invalid = ~uint32_t(0);
+    HandleBase() = default;
+    HandleBase(uint32_t id, uint32_t generation): m_id(id), m_generation(generation) {}
+    uint32_t m_id = Invalid;
+    uint32_t m_generation = 0;
+};
+
+} // namespace detail
+
+/// resolved reference to a configuration value of type V
+/** obtained from \ref Access::valueHandle, remains valid as long as there is an \ref Access instance,
+    using it after the last one has been destroyed is reported as an error.
+    Access via a handle does not require any string hashing or comparison. */
+template<class V>
+class ValueHandle: public detail::HandleBase {
+    friend class Access;
+
+public:
+    ValueHandle() = default; ///< create invalid handle
+
+private:
+    ValueHandle(uint32_t id, uint32_t generation): HandleBase(id, generation) {}
+};
+
+/// resolved reference to a configuration array of type V
+/** obtained from \ref Access::arrayHandle, remains valid as long as there is an \ref Access instance,
+    using it after the last one has been destroyed is reported as an error.
+    Access via a handle does not require any string hashing or comparison. */
+template<class V>
+class ArrayHandle: public detail::HandleBase {
+    friend class Access;
+
+public:
+    ArrayHandle() = default; ///< create invalid handle
+
+private:
+    ArrayHandle(uint32_t id, uint32_t generation): HandleBase(id, generation) {}
+};
+
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
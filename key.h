@@ -0,0 +1,90 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// \file key.h
+/// configuration keys declared at compile time
+#pragma once
+
+#include <string>
+#include <string_view>
+#include "detail/flags.h"
+#include "detail/hash.h"
+#include "detail/typetag.h"
+
+#ifdef CONFIG_NAMESPACE
+namespace CONFIG_NAMESPACE {
+#endif
+
+namespace config {
+
+namespace detail {
+#ifndef DOXYGEN
+template<class V>
+struct KeyDefault {
+    typedef V Type;
+};
+
+template<>
+struct KeyDefault<std::string> {
+    typedef std::string_view Type;
+};
+#endif
+} // namespace detail
+
+/// compile-time descriptor of a configuration value of type V
+/** Declare as `constexpr` in a header, e.g.
+    `constexpr config::Key<int64_t> DebugLevel("plugin", "debug", "level", 0);`
+    Hash and type tag are computed by the compiler,
+    so that obtaining a \ref Value via \ref Access::value does not require hashing any strings at run time.
+    Boolean (`bool`), integral (`int64_t`), floating point (`double`) and string (`std::string`) values are supported. */
+template<class V>
+class Key {
+    static_assert(detail::value_tag<V>() != detail::TypeTag::Section,
+                  "sections cannot be declared as compile-time configuration keys");
+
+public:
+    typedef typename detail::KeyDefault<V>::Type DefaultType; ///< literal type for storing the default value
+
+    constexpr Key(std::string_view path, std::string_view section, std::string_view name,
+                  Flag flags = Flag::Default) ///< key for an existing configuration value
+    : m_path(path)
+    , m_section(section)
+    , m_name(name)
+    , m_hash(detail::hash_key(path, section, name))
+    , m_flags(flags)
+    {}
+    constexpr Key(std::string_view path, std::string_view section, std::string_view name, DefaultType def,
+                  Flag flags = Flag::Default) ///< key for a configuration value with the provided default
+    : m_path(path)
+    , m_section(section)
+    , m_name(name)
+    , m_hash(detail::hash_key(path, section, name))
+    , m_flags(flags)
+    , m_hasDefault(true)
+    , m_default(def)
+    {}
+
+    static constexpr detail::TypeTag tag = detail::value_tag<V>(); ///< type of value
+
+    constexpr std::string_view path() const { return m_path; } ///< configuration file
+    constexpr std::string_view section() const { return m_section; } ///< section within configuration file
+    constexpr std::string_view name() const { return m_name; } ///< name of value within section
+    constexpr uint64_t hash() const { return m_hash; } ///< hash of path, section and name
+    constexpr Flag flags() const { return m_flags; } ///< flags for newly created value
+    constexpr bool hasDefault() const { return m_hasDefault; } ///< whether a default value has been provided
+    constexpr DefaultType defaultValue() const { return m_default; } ///< default value, if provided
+
+private:
+    std::string_view m_path;
+    std::string_view m_section;
+    std::string_view m_name;
+    uint64_t m_hash = 0;
+    Flag m_flags = Flag::Default;
+    bool m_hasDefault = false;
+    DefaultType m_default = DefaultType();
+};
+
+} // namespace config
+#ifdef CONFIG_NAMESPACE
+}
+#endif
@@ -20,7 +20,7 @@ namespace config {
 using namespace detail;
 
 namespace {
-std::string section_prefix(const std::string &root, const std::string &section = std::string())
+std::string section_prefix(const std::string &root, std::string_view section = std::string_view())
 {
     std::string p = root;
     if (!section.empty()) {
@@ -34,14 +34,14 @@ std::string section_prefix(const std::string &root, const std::string &section =
 
 Section::Section(detail::Manager *mgr): Logger("Section"), m_manager(mgr ? mgr : detail::Manager::the())
 {
-    debug() << "default created" << std::endl;
+    CONFIG_DEBUG() << "default created" << std::endl;
 }
 
 Section::Section(Section *parent, const std::string &name)
 : Logger("Section"), m_manager(parent->m_manager), m_config(parent->m_config)
 {
     m_section = section_prefix(parent->sectionname(), name);
-    debug() << "created from parent " << parent->sectionname() << " with section=" << m_section << std::endl;
+    CONFIG_DEBUG() << "created from parent " << parent->sectionname() << " with section=" << m_section << std::endl;
 }
 
 Section::Section(const std::string &path, const std::string &section, detail::Manager *mgr)
@@ -50,24 +50,35 @@ Section::Section(const std::string &path, const std::string &section, detail::Ma
 , m_manager(mgr ? mgr : detail::Manager::the())
 , m_config(m_manager->registerPath(path))
 {
+    // listing the root table requires all tables, see subsections and entries
+    if (!section.empty())
+        m_manager->materialize(*m_config, section);
+    std::shared_lock guard(m_config->mutex);
     m_tomlTable = detail::table_for_section(*this, m_config->config, section);
     if (m_tomlTable) {
         auto tbl = static_cast<const toml::table *>(m_tomlTable);
-        debug() << "created with section=" << m_section << ", table=" << *tbl << std::endl;
+        CONFIG_DEBUG() << "created with section=" << m_section << ", table=" << *tbl << std::endl;
     } else {
-        debug() << "created with section=" << m_section << ", table=(nil)" << std::endl;
+        CONFIG_DEBUG() << "created with section=" << m_section << ", table=(nil)" << std::endl;
     }
 }
 
+Section::Section(detail::Manager *mgr, std::shared_ptr<detail::Config> config, const std::string &section,
+                 const void *tbl)
+: Logger("Section"), m_section(section), m_manager(mgr), m_config(std::move(config)), m_tomlTable(tbl)
+{
+    CONFIG_DEBUG() << "created for table with section=" << m_section << std::endl;
+}
+
 Section::~Section() = default;
 
 void Section::setTomlTable(const void *tbl)
 {
     if (tbl) {
         auto toml = static_cast<const toml::table *>(tbl);
-        debug("setTomlTable") << *toml << std::endl;
+        CONFIG_DEBUG("setTomlTable") << *toml << std::endl;
     } else {
-        debug("setTomlTable") << "(nil)" << std::endl;
+        CONFIG_DEBUG("setTomlTable") << "(nil)" << std::endl;
     }
     m_tomlTable = tbl;
 }
@@ -92,6 +103,8 @@ std::vector<std::string> Section::subsections(const std::string &section)
     if (!prefix.empty())
         prefix += ".";
 
+    m_manager->materialize(*m_config, m_section);
+    std::shared_lock guard(m_config->mutex);
     if (const auto *tbl = static_cast<const toml::table *>(m_tomlTable)) {
         for (auto it = tbl->begin(); it != tbl->end(); ++it) {
             if (it->second.is_table()) {
@@ -106,6 +119,11 @@ std::vector<std::string> Section::subsections(const std::string &section)
 std::vector<std::string> Section::entries(const std::string &section)
 {
     std::vector<std::string> entries;
+    std::shared_lock<std::shared_mutex> guard;
+    if (m_config) {
+        m_manager->materialize(*m_config, m_section.empty() ? section : m_section);
+        guard = std::shared_lock(m_config->mutex);
+    }
     const auto *tbl = static_cast<const toml::table *>(m_tomlTable);
     if (tbl && !section.empty()) {
         if (auto node = (*tbl)[section]) {
@@ -115,69 +133,77 @@ std::vector<std::string> Section::entries(const std::string &section)
         }
     }
     if (tbl) {
-        debug("entries") << "entries for section " + section + ":" << std::endl;
+        CONFIG_DEBUG("entries") << "entries for section " + section + ":" << std::endl;
         for (auto it = tbl->begin(); it != tbl->end(); ++it) {
-            debug("entries") << "   " + std::string(it->first.str()) << std::endl;
+            CONFIG_DEBUG("entries") << "   " + std::string(it->first.str()) << std::endl;
             if (!it->second.is_table())
                 entries.emplace_back(it->first.str());
         }
     } else {
-        debug("entries") << "no entries for section " + section << std::endl;
+        CONFIG_DEBUG("entries") << "no entries for section " + section << std::endl;
     }
     return entries;
 }
 
 template<class V>
-ValuePtr<V> Section::value(const std::string &section, const std::string &name)
+std::optional<V> Section::fromTable(Value<V> *value, std::string_view name) const
+{
+    const auto *tbl = static_cast<const toml::table *>(m_tomlTable);
+    if (!tbl)
+        return std::nullopt;
+    // released before the value is assigned, which requires the exclusive lock
+    std::shared_lock<std::shared_mutex> guard;
+    if (m_config)
+        guard = std::shared_lock(m_config->mutex);
+    CONFIG_DEBUG("value") << " getting from TOML table: " << *tbl << std::endl;
+    return Convert<V>::get_from_table(value->m_entry, tbl, name);
+}
+
+template<class V>
+ValuePtr<V> Section::value(std::string_view section, std::string_view name)
 {
-    debug("value") << " for " << section << "." << name << " without default" << std::endl;
+    CONFIG_DEBUG("value") << " for " << section << "." << name << " without default" << std::endl;
     auto prefix = section_prefix(m_section, section);
     ValuePtr<V> vptr;
     if (m_config) {
         vptr = std::make_unique<Value<V>>(m_config->path, prefix, name, m_manager);
     } else {
-        debug("value") << "creating tables for accessing section" << std::endl;
+        CONFIG_DEBUG("value") << "creating tables for accessing section" << std::endl;
         vptr = std::make_unique<Value<V>>("", prefix, name, m_manager);
     }
-    if (const auto *tbl = static_cast<const toml::table *>(m_tomlTable)) {
-        debug("value") << " getting from TOML table: " << *tbl << std::endl;
-        if (auto opt = Convert<V>::get_from_table(vptr->m_entry, tbl, name)) {
-            *vptr = *opt;
-        }
+    if (auto opt = fromTable<V>(vptr.get(), name)) {
+        *vptr = *opt;
     }
 
     return vptr;
 }
 
 template<class V>
-ValuePtr<V> Section::value(const std::string &section, const std::string &name, const V &def, Flag flags)
+ValuePtr<V> Section::value(std::string_view section, std::string_view name, const V &def, Flag flags)
 {
-    debug("value") << " for " << section << "." << name << " with default " << def << std::endl;
+    CONFIG_DEBUG("value") << " for " << section << "." << name << " with default " << def << std::endl;
     auto prefix = section_prefix(m_section, section);
     ValuePtr<V> vptr;
     if (m_config) {
         vptr = std::make_unique<Value<V>>(m_config->path, prefix, name, def, m_manager, flags);
     } else {
-        debug("value") << "creating tables for accessing section" << std::endl;
+        CONFIG_DEBUG("value") << "creating tables for accessing section" << std::endl;
         vptr = std::make_unique<Value<V>>("", prefix, name, m_manager);
     }
 
-    if (const auto *tbl = static_cast<const toml::table *>(m_tomlTable)) {
-        debug("value") << " getting from TOML table: " << *tbl << std::endl;
-        if (auto opt = Convert<V>::get_from_table(vptr->m_entry, tbl, name)) {
-            *vptr = *opt;
-        }
+    if (auto opt = fromTable<V>(vptr.get(), name)) {
+        *vptr = *opt;
     }
 
     return vptr;
 }
 
 template<class V>
-std::unique_ptr<Array<V>> Section::array(const std::string &section, const std::string &name)
+std::unique_ptr<Array<V>> Section::array(std::string_view section, std::string_view name)
 {
     auto prefix = section_prefix(m_section, section);
     if (!m_config) {
-        debug("array") << "creating tables for accessing section" << std::endl;
+        CONFIG_DEBUG("array") << "creating tables for accessing section" << std::endl;
         return std::make_unique<Array<V>>("", prefix, name, m_manager);
     }
 
@@ -185,12 +211,12 @@ std::unique_ptr<Array<V>> Section::array(const std::string &section, const std::
 }
 
 template<class V>
-std::unique_ptr<Array<V>> Section::array(const std::string &section, const std::string &name, const std::vector<V> &def,
+std::unique_ptr<Array<V>> Section::array(std::string_view section, std::string_view name, const std::vector<V> &def,
                                          Flag flags)
 {
     auto prefix = section_prefix(m_section, section);
     if (!m_config) {
-        debug("array") << "creating tables for accessing section" << std::endl;
+        CONFIG_DEBUG("array") << "creating tables for accessing section" << std::endl;
         return std::make_unique<Array<V>>("", prefix, name, m_manager);
     }
 
@@ -201,8 +227,8 @@ std::ostream &operator<<(std::ostream &os, const Section &section)
 {
     os << "section: " << section.sectionname();
     if (section.m_config) {
-        auto conf = section.m_config->config;
-        auto sec = section.m_section;
+        section.m_manager->materialize(*section.m_config, section.m_section);
+        std::shared_lock guard(section.m_config->mutex);
         auto tbl = static_cast<const toml::table *>(section.m_tomlTable);
         if (tbl)
             os << ", " << *tbl << std::endl;
@@ -231,39 +257,39 @@ bool operator!=(const Section &lhs, const Section &rhs)
 }
 
 
-template std::unique_ptr<Value<bool>> COVEXPORT Section::value<bool>(const std::string &section,
-                                                                     const std::string &name);
-template std::unique_ptr<Value<int64_t>> COVEXPORT Section::value<int64_t>(const std::string &section,
-                                                                           const std::string &name);
-template std::unique_ptr<Value<double>> COVEXPORT Section::value<double>(const std::string &section,
-                                                                         const std::string &name);
-template std::unique_ptr<Value<std::string>> COVEXPORT Section::value<std::string>(const std::string &section,
-                                                                                   const std::string &name);
-template std::unique_ptr<Value<Section>> COVEXPORT Section::value<Section>(const std::string &section,
-                                                                           const std::string &name);
-template std::unique_ptr<Value<bool>> COVEXPORT Section::value(const std::string &section, const std::string &name,
+template std::unique_ptr<Value<bool>> COVEXPORT Section::value<bool>(std::string_view section,
+                                                                     std::string_view name);
+template std::unique_ptr<Value<int64_t>> COVEXPORT Section::value<int64_t>(std::string_view section,
+                                                                           std::string_view name);
+template std::unique_ptr<Value<double>> COVEXPORT Section::value<double>(std::string_view section,
+                                                                         std::string_view name);
+template std::unique_ptr<Value<std::string>> COVEXPORT Section::value<std::string>(std::string_view section,
+                                                                                   std::string_view name);
+template std::unique_ptr<Value<Section>> COVEXPORT Section::value<Section>(std::string_view section,
+                                                                           std::string_view name);
+template std::unique_ptr<Value<bool>> COVEXPORT Section::value(std::string_view section, std::string_view name,
                                                                const bool &def, Flag flags);
-template std::unique_ptr<Value<int64_t>> COVEXPORT Section::value(const std::string &section, const std::string &name,
+template std::unique_ptr<Value<int64_t>> COVEXPORT Section::value(std::string_view section, std::string_view name,
                                                                   const int64_t &def, Flag flags);
-template std::unique_ptr<Value<double>> COVEXPORT Section::value(const std::string &section, const std::string &name,
+template std::unique_ptr<Value<double>> COVEXPORT Section::value(std::string_view section, std::string_view name,
                                                                  const double &def, Flag flags);
 template std::unique_ptr<Value<std::string>>
-    COVEXPORT Section::value(const std::string &section, const std::string &name, const std::string &def, Flag flags);
-
-template std::unique_ptr<Array<bool>> COVEXPORT Section::array(const std::string &section, const std::string &name);
-template std::unique_ptr<Array<int64_t>> COVEXPORT Section::array(const std::string &section, const std::string &name);
-template std::unique_ptr<Array<double>> COVEXPORT Section::array(const std::string &section, const std::string &name);
-template std::unique_ptr<Array<std::string>> COVEXPORT Section::array(const std::string &section,
-                                                                      const std::string &name);
-template std::unique_ptr<Array<Section>> COVEXPORT Section::array(const std::string &section, const std::string &name);
-template std::unique_ptr<Array<bool>> COVEXPORT Section::array(const std::string &section, const std::string &name,
+    COVEXPORT Section::value(std::string_view section, std::string_view name, const std::string &def, Flag flags);
+
+template std::unique_ptr<Array<bool>> COVEXPORT Section::array(std::string_view section, std::string_view name);
+template std::unique_ptr<Array<int64_t>> COVEXPORT Section::array(std::string_view section, std::string_view name);
+template std::unique_ptr<Array<double>> COVEXPORT Section::array(std::string_view section, std::string_view name);
+template std::unique_ptr<Array<std::string>> COVEXPORT Section::array(std::string_view section,
+                                                                      std::string_view name);
+template std::unique_ptr<Array<Section>> COVEXPORT Section::array(std::string_view section, std::string_view name);
+template std::unique_ptr<Array<bool>> COVEXPORT Section::array(std::string_view section, std::string_view name,
                                                                const std::vector<bool> &def, Flag flags);
-template std::unique_ptr<Array<int64_t>> COVEXPORT Section::array(const std::string &section, const std::string &name,
+template std::unique_ptr<Array<int64_t>> COVEXPORT Section::array(std::string_view section, std::string_view name,
                                                                   const std::vector<int64_t> &def, Flag flags);
-template std::unique_ptr<Array<double>> COVEXPORT Section::array(const std::string &section, const std::string &name,
+template std::unique_ptr<Array<double>> COVEXPORT Section::array(std::string_view section, std::string_view name,
                                                                  const std::vector<double> &def, Flag flags);
-template std::unique_ptr<Array<std::string>> COVEXPORT Section::array(const std::string &section,
-                                                                      const std::string &name,
+template std::unique_ptr<Array<std::string>> COVEXPORT Section::array(std::string_view section,
+                                                                      std::string_view name,
                                                                       const std::vector<std::string> &def, Flag flags);
 
 } // namespace config
@@ -6,7 +6,9 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
+#include <optional>
 #include <vector>
 #include <iosfwd>
 #include "detail/export.h"
@@ -56,69 +58,75 @@ public:
     std::vector<std::string> entries(const std::string &section); ///< all entries within a (sub-)section
 
     template<class V>
-    ValuePtr<V> value(const std::string &section,
-                      const std::string &name); ///< query existing configuration value
+    ValuePtr<V> value(std::string_view section,
+                      std::string_view name); ///< query existing configuration value
     template<class V>
-    ValuePtr<V> value(const std::string &section, const std::string &name, const V &def,
+    ValuePtr<V> value(std::string_view section, std::string_view name, const V &def,
                       Flag flags = Flag::Default); ///< create configuration value with the provided default
 
     template<class V>
-    std::unique_ptr<Array<V>> array(const std::string &section,
-                                    const std::string &name); ///< query existing configuration array
+    std::unique_ptr<Array<V>> array(std::string_view section,
+                                    std::string_view name); ///< query existing configuration array
     template<class V>
     std::unique_ptr<Array<V>>
-    array(const std::string &section, const std::string &name, const std::vector<V> &def,
+    array(std::string_view section, std::string_view name, const std::vector<V> &def,
           Flag flags = Flag::Default); ///< create configuration array with the provided default
 
     void setTomlTable(const void *tbl);
 
 private:
+    Section(detail::Manager *mgr, std::shared_ptr<detail::Config> config, const std::string &section,
+            const void *tbl); ///< create for an already known table, while the lock on config is held
+    template<class V>
+    std::optional<V> fromTable(Value<V> *value,
+                               std::string_view name) const; ///< read name from table, holding the lock on config
+
     std::string m_section;
     detail::Manager *m_manager = nullptr;
     std::shared_ptr<detail::Config> m_config;
     const void *m_tomlTable = nullptr;
 };
 
-extern template std::unique_ptr<Value<bool>> COVEXPORT Section::value<bool>(const std::string &section,
-                                                                            const std::string &name);
-extern template std::unique_ptr<Value<int64_t>> COVEXPORT Section::value<int64_t>(const std::string &section,
-                                                                                  const std::string &name);
-extern template std::unique_ptr<Value<double>> COVEXPORT Section::value<double>(const std::string &section,
-                                                                                const std::string &name);
-extern template std::unique_ptr<Value<std::string>> COVEXPORT Section::value<std::string>(const std::string &section,
-                                                                                          const std::string &name);
-extern template std::unique_ptr<Value<Section>> COVEXPORT Section::value<Section>(const std::string &section,
-                                                                                  const std::string &name);
+extern template std::unique_ptr<Value<bool>> COVEXPORT Section::value<bool>(std::string_view section,
+                                                                            std::string_view name);
+extern template std::unique_ptr<Value<int64_t>> COVEXPORT Section::value<int64_t>(std::string_view section,
+                                                                                  std::string_view name);
+extern template std::unique_ptr<Value<double>> COVEXPORT Section::value<double>(std::string_view section,
+                                                                                std::string_view name);
+extern template std::unique_ptr<Value<std::string>> COVEXPORT Section::value<std::string>(std::string_view section,
+                                                                                          std::string_view name);
+extern template std::unique_ptr<Value<Section>> COVEXPORT Section::value<Section>(std::string_view section,
+                                                                                  std::string_view name);
 extern template std::unique_ptr<Value<bool>>
-    COVEXPORT Section::value(const std::string &section, const std::string &name, const bool &def, Flag flags);
+    COVEXPORT Section::value(std::string_view section, std::string_view name, const bool &def, Flag flags);
 extern template std::unique_ptr<Value<int64_t>>
-    COVEXPORT Section::value(const std::string &section, const std::string &name, const int64_t &def, Flag flags);
+    COVEXPORT Section::value(std::string_view section, std::string_view name, const int64_t &def, Flag flags);
 extern template std::unique_ptr<Value<double>>
-    COVEXPORT Section::value(const std::string &section, const std::string &name, const double &def, Flag flags);
+    COVEXPORT Section::value(std::string_view section, std::string_view name, const double &def, Flag flags);
 extern template std::unique_ptr<Value<std::string>>
-    COVEXPORT Section::value(const std::string &section, const std::string &name, const std::string &def, Flag flags);
-
-extern template std::unique_ptr<Array<bool>> COVEXPORT Section::array(const std::string &section,
-                                                                      const std::string &name);
-extern template std::unique_ptr<Array<int64_t>> COVEXPORT Section::array(const std::string &section,
-                                                                         const std::string &name);
-extern template std::unique_ptr<Array<double>> COVEXPORT Section::array(const std::string &section,
-                                                                        const std::string &name);
-extern template std::unique_ptr<Array<std::string>> COVEXPORT Section::array(const std::string &section,
-                                                                             const std::string &name);
-extern template std::unique_ptr<Array<Section>> COVEXPORT Section::array(const std::string &section,
-                                                                         const std::string &name);
-extern template std::unique_ptr<Array<bool>> COVEXPORT Section::array(const std::string &section,
-                                                                      const std::string &name,
+    COVEXPORT Section::value(std::string_view section, std::string_view name, const std::string &def, Flag flags);
+
+extern template std::unique_ptr<Array<bool>> COVEXPORT Section::array(std::string_view section,
+                                                                      std::string_view name);
+extern template std::unique_ptr<Array<int64_t>> COVEXPORT Section::array(std::string_view section,
+                                                                         std::string_view name);
+extern template std::unique_ptr<Array<double>> COVEXPORT Section::array(std::string_view section,
+                                                                        std::string_view name);
+extern template std::unique_ptr<Array<std::string>> COVEXPORT Section::array(std::string_view section,
+                                                                             std::string_view name);
+extern template std::unique_ptr<Array<Section>> COVEXPORT Section::array(std::string_view section,
+                                                                         std::string_view name);
+extern template std::unique_ptr<Array<bool>> COVEXPORT Section::array(std::string_view section,
+                                                                      std::string_view name,
                                                                       const std::vector<bool> &def, Flag flags);
-extern template std::unique_ptr<Array<int64_t>> COVEXPORT Section::array(const std::string &section,
-                                                                         const std::string &name,
+extern template std::unique_ptr<Array<int64_t>> COVEXPORT Section::array(std::string_view section,
+                                                                         std::string_view name,
                                                                          const std::vector<int64_t> &def, Flag flags);
-extern template std::unique_ptr<Array<double>> COVEXPORT Section::array(const std::string &section,
-                                                                        const std::string &name,
+extern template std::unique_ptr<Array<double>> COVEXPORT Section::array(std::string_view section,
+                                                                        std::string_view name,
                                                                         const std::vector<double> &def, Flag flags);
-extern template std::unique_ptr<Array<std::string>> COVEXPORT Section::array(const std::string &section,
-                                                                             const std::string &name,
+extern template std::unique_ptr<Array<std::string>> COVEXPORT Section::array(std::string_view section,
+                                                                             std::string_view name,
                                                                              const std::vector<std::string> &def,
                                                                              Flag flags);
 
@@ -0,0 +1,217 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+// forked processes load a file collectively via pipes:
+// the common file exists only in the search path of the root, while one rank has a host specific file of its own
+
+#include "../access.h"
+#include "../collective.h"
+#include "../value.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace config;
+
+namespace {
+
+bool write_all(int fd, const char *data, size_t size)
+{
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool read_all(int fd, char *data, size_t size)
+{
+    while (size > 0) {
+        ssize_t n = ::read(fd, data, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+/// stand-in transport for processes forked from a common parent
+/** Create before forking and call \ref setRank in every process afterwards.
+    Rank 0 is the root, it writes to a pipe for each of the other ranks. */
+class PipeCollective: public Collective {
+public:
+    explicit PipeCollective(int size); ///< prepare pipes for size processes
+    PipeCollective(const PipeCollective &) = delete;
+    PipeCollective &operator=(const PipeCollective &) = delete;
+    ~PipeCollective() override;
+
+    void setRank(int rank); ///< select rank after forking, closes pipes not used by this process
+    int size() const; ///< number of participating processes
+    int rank() const override;
+    bool broadcast(std::string &data) override;
+
+private:
+    int m_rank = -1;
+    std::vector<int> m_read; // read end of pipe for each rank
+    std::vector<int> m_write; // write end of pipe for each rank
+};
+
+PipeCollective::PipeCollective(int size): m_read(size, -1), m_write(size, -1)
+{
+    // rank 0 is root and does not receive
+    for (int r = 1; r < size; ++r) {
+        int fd[2];
+        if (pipe(fd) == 0) {
+            m_read[r] = fd[0];
+            m_write[r] = fd[1];
+        }
+    }
+}
+
+PipeCollective::~PipeCollective()
+{
+    for (auto fds: {&m_read, &m_write}) {
+        for (auto &fd: *fds) {
+            if (fd >= 0)
+                close(fd);
+            fd = -1;
+        }
+    }
+}
+
+void PipeCollective::setRank(int rank)
+{
+    m_rank = rank;
+    for (int r = 0; r < size(); ++r) {
+        if (r != rank && m_read[r] >= 0) {
+            close(m_read[r]);
+            m_read[r] = -1;
+        }
+        if (rank != 0 && m_write[r] >= 0) {
+            close(m_write[r]);
+            m_write[r] = -1;
+        }
+    }
+}
+
+int PipeCollective::size() const
+{
+    return int(m_read.size());
+}
+
+int PipeCollective::rank() const
+{
+    return m_rank;
+}
+
+bool PipeCollective::broadcast(std::string &data)
+{
+    if (m_rank < 0 || m_rank >= size())
+        return false;
+
+    if (m_rank == root()) {
+        // receivers drain their pipes independently, so writing in sequence cannot deadlock
+        const uint64_t len = data.size();
+        bool ok = true;
+        for (int r = 0; r < size(); ++r) {
+            if (r == root())
+                continue;
+            if (m_write[r] < 0 || !write_all(m_write[r], reinterpret_cast<const char *>(&len), sizeof(len)) ||
+                !write_all(m_write[r], data.data(), data.size()))
+                ok = false;
+        }
+        return ok;
+    }
+
+    uint64_t len = 0;
+    if (m_read[m_rank] < 0 || !read_all(m_read[m_rank], reinterpret_cast<char *>(&len), sizeof(len)))
+        return false;
+    data.resize(len);
+    return read_all(m_read[m_rank], data.data(), data.size());
+}
+
+const int Ranks = 3;
+const int SpecificRank = 2; // rank with a host specific file
+
+int run(PipeCollective &collective, int rank, const std::filesystem::path &dir)
+{
+    collective.setRank(rank);
+    // only root can find the common file
+    const auto searchDir = rank == collective.root() ? dir / "common" : dir / "local";
+    setenv("COVCONFIG", searchDir.string().c_str(), 1);
+    setenv("XDG_CONFIG_HOME", (dir / "user").string().c_str(), 1);
+    setenv("XDG_CONFIG_DIRS", (dir / "system").string().c_str(), 1);
+
+    Access access("host" + std::to_string(rank), "");
+    access.load({"collective"}, collective);
+    auto value = access.value<int64_t>("collective", "section", "value");
+    const int64_t expected = rank == SpecificRank ? 2 : 1;
+    if (!value || value->value() != expected) {
+        std::cerr << "FAILED: rank " << rank << ": expected " << expected << ", got "
+                  << (value ? std::to_string(value->value()) : "no value") << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main()
+{
+    const auto dir = std::filesystem::temp_directory_path() / ("covconfig-test-" + std::to_string(getpid()));
+    const auto specific = dir / "local" / ("h_host" + std::to_string(SpecificRank));
+    std::filesystem::create_directories(dir / "common");
+    std::filesystem::create_directories(specific);
+    std::filesystem::create_directories(dir / "user");
+    {
+        std::ofstream f(dir / "common" / "collective.toml");
+        f << "[section]\nvalue = 1\n";
+    }
+    {
+        std::ofstream f(specific / "collective.toml");
+        f << "[section]\nvalue = 2\n";
+    }
+
+    PipeCollective collective(Ranks);
+    std::vector<pid_t> children;
+    for (int r = 1; r < Ranks; ++r) {
+        pid_t pid = fork();
+        if (pid == 0)
+            _exit(run(collective, r, dir));
+        if (pid > 0)
+            children.push_back(pid);
+    }
+
+    int failures = children.size() == Ranks - 1 ? 0 : 1;
+    failures += run(collective, 0, dir);
+    for (auto pid: children) {
+        int status = 0;
+        if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            ++failures;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    if (failures > 0) {
+        std::cerr << failures << " processes failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+// values of a file large enough for deferred parsing of its tables are read back,
+// including tables that extend a table defined by dotted keys before the first table header
+
+#include "../access.h"
+#include "../value.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace config;
+
+namespace {
+
+const int Sections = 20000; // exceeds threshold for lazy parsing
+
+int failures = 0;
+
+void check(bool ok, const std::string &what)
+{
+    if (!ok) {
+        ++failures;
+        std::cerr << "FAILED: " << what << std::endl;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    const auto dir = std::filesystem::temp_directory_path() / ("covconfig-test-" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir / "user");
+#ifdef _WIN32
+    _putenv_s("COVCONFIG", dir.string().c_str());
+    _putenv_s("XDG_CONFIG_HOME", (dir / "user").string().c_str());
+    _putenv_s("COVCONFIG_LAZY", "1");
+#else
+    setenv("COVCONFIG", dir.string().c_str(), 1);
+    setenv("XDG_CONFIG_HOME", (dir / "user").string().c_str(), 1);
+    setenv("COVCONFIG_LAZY", "1", 1);
+#endif
+    {
+        std::ofstream f(dir / "lazy.toml");
+        f << "a.b = 1\n";
+        f << "[a.c]\nd = 2\n";
+        for (int s = 0; s < Sections; ++s)
+            f << "[section" << s << "]\nvalue = " << s << "\n";
+        f << "[a.e]\nf = 3\n";
+    }
+    check(std::filesystem::file_size(dir / "lazy.toml") >= 256 * 1024, "file too small for lazy parsing");
+
+    {
+        Access access("", "");
+        auto last = access.value<int64_t>("lazy", "section" + std::to_string(Sections - 1), "value");
+        check(last && last->value() == Sections - 1, "value of last section");
+        auto b = access.value<int64_t>("lazy", "a", "b");
+        check(b && b->value() == 1, "value defined by dotted key");
+        auto d = access.value<int64_t>("lazy", "a.c", "d");
+        check(d && d->value() == 2, "value in table extending dotted key");
+        auto f = access.value<int64_t>("lazy", "a.e", "f");
+        check(f && f->value() == 3, "value in later table extending dotted key");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    if (failures > 0) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+// a file including another one is loaded twice with retention enabled,
+// the second time its retained contents are reused once the first Access is gone
+
+#include "../access.h"
+#include "../value.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace config;
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string &what)
+{
+    if (!ok) {
+        ++failures;
+        std::cerr << "FAILED: " << what << std::endl;
+    }
+}
+
+void read(const std::string &round)
+{
+    Access access("", "");
+    auto value = access.value<int64_t>("retained", "section", "value");
+    check(value && value->value() == 1, round + ": value of retained file");
+    auto included = access.value<int64_t>("retained", "included", "value");
+    check(included && included->value() == 2, round + ": value of included file");
+}
+
+} // namespace
+
+int main()
+{
+    const auto dir = std::filesystem::temp_directory_path() / ("covconfig-test-" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir / "user");
+#ifdef _WIN32
+    _putenv_s("COVCONFIG", dir.string().c_str());
+    _putenv_s("XDG_CONFIG_HOME", (dir / "user").string().c_str());
+#else
+    setenv("COVCONFIG", dir.string().c_str(), 1);
+    setenv("XDG_CONFIG_HOME", (dir / "user").string().c_str(), 1);
+#endif
+    {
+        std::ofstream f(dir / "retained.toml");
+        f << "\"@include\" = { included = \"fragment\" }\n";
+        f << "[section]\nvalue = 1\n";
+    }
+    {
+        std::ofstream f(dir / "fragment.toml");
+        f << "value = 2\n";
+    }
+
+    Access::retainConfiguration(true);
+    read("first load");
+    read("second load");
+    Access::retainConfiguration(false);
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    if (failures > 0) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
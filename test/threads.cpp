@@ -0,0 +1,135 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+// readers traverse sections and read values of a file while writers assign and insert values into it,
+// meant to be run under ThreadSanitizer
+
+#include "../access.h"
+#include "../array.h"
+#include "../file.h"
+#include "../value.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace config;
+
+namespace {
+
+const int Writers = 2;
+const int Readers = 4;
+const int Iterations = 2000;
+const int Sections = 4;
+const int Values = 8;
+
+std::atomic<int> failures{0};
+
+void check(bool ok, const std::string &what)
+{
+    if (!ok) {
+        ++failures;
+        std::cerr << "FAILED: " << what << std::endl;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    const auto dir = std::filesystem::temp_directory_path() / ("covconfig-test-" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir / "user");
+#ifdef _WIN32
+    _putenv_s("COVCONFIG", dir.string().c_str());
+    _putenv_s("XDG_CONFIG_HOME", (dir / "user").string().c_str());
+#else
+    setenv("COVCONFIG", dir.string().c_str(), 1);
+    setenv("XDG_CONFIG_HOME", (dir / "user").string().c_str(), 1);
+#endif
+    {
+        std::ofstream f(dir / "threads.toml");
+        for (int s = 0; s < Sections; ++s) {
+            f << "[section" << s << "]\n";
+            for (int v = 0; v < Values; ++v)
+                f << "value" << v << " = " << v << "\n";
+            f << "array = [0, 1, 2]\n";
+        }
+    }
+
+    {
+        Access access("", "");
+
+        // values are only shared between threads via handles, as observers may not be added concurrently
+        std::vector<ValueHandle<int64_t>> handles;
+        for (int w = 0; w < Writers; ++w)
+            handles.push_back(access.valueHandle<int64_t>("threads", "section" + std::to_string(w), "value0"));
+
+        std::atomic<bool> done{false};
+        std::vector<std::thread> threads;
+        for (int w = 0; w < Writers; ++w) {
+            threads.emplace_back([&access, w]() {
+                const std::string section = "section" + std::to_string(w);
+                auto value = access.value<int64_t>("threads", section, "value0");
+                auto array = access.array<int64_t>("threads", section, "array");
+                for (int i = 0; i < Iterations; ++i) {
+                    *value = i;
+                    *array = std::vector<int64_t>{i, i + 1, i + 2};
+                    // insert new keys into the table traversed by readers
+                    auto added = access.value<int64_t>("threads", section, "added" + std::to_string(i), -1);
+                    *added = i;
+                }
+            });
+        }
+        for (int r = 0; r < Readers; ++r) {
+            threads.emplace_back([&access, &handles, &done]() {
+                auto file = access.file("threads");
+                while (!done) {
+                    for (const auto &section: file->sections()) {
+                        const auto entries = file->entries(section);
+                        check(entries.size() >= Values + 1, section + ": missing entries");
+                        // not assigned by writers
+                        auto value = file->value<int64_t>(section, "value" + std::to_string(Values - 1));
+                        check(value && value->snapshot() == Values - 1, section + ": unexpected value");
+                    }
+                    for (const auto &h: handles) {
+                        const auto v = access.snapshot(h);
+                        check(v >= 0 && v < Iterations, "value out of range");
+                    }
+                }
+            });
+        }
+        for (int w = 0; w < Writers; ++w)
+            threads[w].join();
+        done = true;
+        for (size_t t = Writers; t < threads.size(); ++t)
+            threads[t].join();
+
+        for (const auto &h: handles)
+            check(access.get(h) == Iterations - 1, "last assignment lost");
+        for (int w = 0; w < Writers; ++w) {
+            auto file = access.file("threads");
+            check(file->entries("section" + std::to_string(w)).size() == Values + 1 + Iterations,
+                  "inserted values missing");
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    if (failures > 0) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
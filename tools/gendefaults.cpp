@@ -0,0 +1,208 @@
+// Copyright (C) High-Performance Computing Center Stuttgart (https://www.hlrs.de/)
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+// compile TOML files with default value overrides into C++ tables,
+// invoked at build time by covconfig_compile_defaults (see covconfig.cmake)
+
+#include "../detail/toml/toml.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct Default {
+    std::string path;
+    std::string section;
+    std::string name;
+    const toml::node *node = nullptr;
+    std::string file; // for error messages
+
+    bool operator<(const Default &o) const
+    {
+        return std::tie(path, section, name) < std::tie(o.path, o.section, o.name);
+    }
+};
+
+bool is_scalar(const toml::node &node)
+{
+    switch (node.type()) {
+    case toml::node_type::string:
+    case toml::node_type::integer:
+    case toml::node_type::floating_point:
+    case toml::node_type::boolean:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool collect(const std::string &file, const std::string &path, const std::string &section, const toml::table &tbl,
+             std::vector<Default> &defaults)
+{
+    for (auto &&[key, node]: tbl) {
+        std::string name(key.str());
+        if (auto sub = node.as_table()) {
+            if (!collect(file, path, section.empty() ? name : section + "." + name, *sub, defaults))
+                return false;
+            continue;
+        }
+        if (auto arr = node.as_array()) {
+            for (auto &member: *arr) {
+                if (!is_scalar(member) || member.type() != (*arr)[0].type()) {
+                    std::cerr << file << ": " << section << "." << name
+                              << ": only arrays of strings, integers, floating point numbers or booleans are supported"
+                              << std::endl;
+                    return false;
+                }
+            }
+        } else if (!is_scalar(node)) {
+            std::cerr << file << ": " << section << "." << name << ": dates and times are not supported" << std::endl;
+            return false;
+        }
+        defaults.push_back(Default{path, section, name, &node, file});
+    }
+    return true;
+}
+
+std::string literal(std::string_view s)
+{
+    std::ostringstream str;
+    str << "std::string_view(\"";
+    for (unsigned char c: s) {
+        if (c == '"' || c == '\\') {
+            str << '\\' << c;
+        } else if (c >= 0x20 && c < 0x7f) {
+            str << c;
+        } else {
+            str << '\\' << std::oct << std::setw(3) << std::setfill('0') << int(c) << std::dec;
+        }
+    }
+    str << "\", " << s.size() << ")";
+    return str.str();
+}
+
+std::string value(const toml::node &node)
+{
+    std::ostringstream str;
+    if (auto b = node.as<bool>()) {
+        str << "{TypeTag::Bool, " << (b->get() ? "true" : "false") << ", 0, 0., {}}";
+    } else if (auto i = node.as<int64_t>()) {
+        str << "{TypeTag::Integer, false, ";
+        if (i->get() == std::numeric_limits<int64_t>::min())
+            str << "std::numeric_limits<int64_t>::min()";
+        else
+            str << i->get();
+        str << ", 0., {}}";
+    } else if (auto d = node.as<double>()) {
+        str << "{TypeTag::Double, false, 0, ";
+        if (std::isnan(d->get()))
+            str << "std::numeric_limits<double>::quiet_NaN()";
+        else if (std::isinf(d->get()))
+            str << (d->get() < 0 ? "-" : "") << "std::numeric_limits<double>::infinity()";
+        else
+            str << std::hexfloat << d->get() << std::defaultfloat;
+        str << ", {}}";
+    } else if (auto s = node.as<std::string>()) {
+        str << "{TypeTag::String, false, 0, 0., " << literal(s->get()) << "}";
+    }
+    return str.str();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <defaults.h> <output.cpp> [<path>.toml ...]" << std::endl;
+        return 2;
+    }
+    const std::string header = argv[1];
+    const std::string output = argv[2];
+
+    std::list<toml::table> tables;
+    std::vector<Default> defaults;
+    for (int i = 3; i < argc; ++i) {
+        const std::string file = argv[i];
+        try {
+            tables.push_back(toml::parse_file(file));
+        } catch (toml::parse_error &ex) {
+            std::cerr << ex << std::endl;
+            return 1;
+        }
+        const std::string path = std::filesystem::path(file).stem().string();
+        if (!collect(file, path, "", tables.back(), defaults))
+            return 1;
+    }
+
+    std::sort(defaults.begin(), defaults.end());
+    for (size_t i = 1; i < defaults.size(); ++i) {
+        const auto &a = defaults[i - 1], &b = defaults[i];
+        if (!(a < b)) {
+            std::cerr << b.file << ": " << b.section << "." << b.name << " already defined in " << a.file << std::endl;
+            return 1;
+        }
+    }
+
+    std::ostringstream str;
+    str << "// generated by covconfig_gendefaults - do not edit\n\n";
+    str << "#include \"" << header << "\"\n\n";
+    str << "#ifdef CONFIG_NAMESPACE\nnamespace CONFIG_NAMESPACE {\n#endif\n\n";
+    str << "namespace config {\nnamespace detail {\n\n";
+
+    str << "namespace {\n";
+    for (size_t i = 0; i < defaults.size(); ++i) {
+        auto arr = defaults[i].node->as_array();
+        if (!arr || arr->empty())
+            continue;
+        str << "constexpr CompiledValue elements" << i << "[] = {\n";
+        for (auto &member: *arr)
+            str << "    " << value(member) << ",\n";
+        str << "};\n";
+    }
+    str << "} // namespace\n\n";
+
+    str << "extern const CompiledDefault compiled_defaults[];\n";
+    str << "extern const size_t num_compiled_defaults;\n\n";
+    str << "constexpr CompiledDefault compiled_defaults[" << std::max(defaults.size(), size_t(1)) << "] = {\n";
+    for (size_t i = 0; i < defaults.size(); ++i) {
+        const auto &d = defaults[i];
+        str << "    {" << literal(d.path) << ", " << literal(d.section) << ", " << literal(d.name) << ", ";
+        if (auto arr = d.node->as_array()) {
+            str << "{TypeTag::Array, false, 0, 0., {}}, ";
+            if (arr->empty())
+                str << "nullptr, 0";
+            else
+                str << "elements" << i << ", " << arr->size();
+        } else {
+            str << value(*d.node) << ", nullptr, 0";
+        }
+        str << "},\n";
+    }
+    str << "};\n";
+    str << "constexpr size_t num_compiled_defaults = " << defaults.size() << ";\n";
+    str << "static_assert(compiled_defaults_sorted(compiled_defaults, num_compiled_defaults),\n"
+        << "              \"compiled defaults have to be sorted for lookup\");\n\n";
+
+    str << "} // namespace detail\n} // namespace config\n";
+    str << "#ifdef CONFIG_NAMESPACE\n}\n#endif\n";
+
+    std::ofstream f(output);
+    f << str.str();
+    if (!f) {
+        std::cerr << "failed to write " << output << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -13,7 +13,7 @@ namespace config {
 using namespace detail;
 
 template<class V>
-Value<V>::Value(const std::string &path, const std::string &section, const std::string &name, const V &value,
+Value<V>::Value(std::string_view path, std::string_view section, std::string_view name, const V &value,
                 Manager *mgr, Flag flags)
 : ConfigBase("Value")
 {
@@ -21,13 +21,14 @@ Value<V>::Value(const std::string &path, const std::string &section, const std::
         mgr = Manager::the();
     m_entry = mgr->getValue<V>(path, section, name, flags);
     entry()->setOrCheckDefaultValue(value);
-    debug() << key() << " initialized to " << entry()->value() << " (default: " << defaultValue() << ")" << std::endl;
+    CONFIG_DEBUG() << key() << " initialized to " << entry()->value() << " (default: " << defaultValue() << ")"
+                   << std::endl;
     entry()->addObserver(this);
     entry()->assign();
 }
 
 template<class V>
-Value<V>::Value(const std::string &path, const std::string &section, const std::string &name, Manager *mgr)
+Value<V>::Value(std::string_view path, std::string_view section, std::string_view name, Manager *mgr)
 : ConfigBase("Value")
 {
     if (!mgr)
@@ -68,10 +69,16 @@ const V &Value<V>::value() const
     return entry()->value();
 }
 
+template<class V>
+V Value<V>::snapshot() const
+{
+    return entry()->snapshot();
+}
+
 template<class V>
 Value<V>::operator V() const
 {
-    return value();
+    return entry()->snapshot();
 }
 
 template<class V>
@@ -84,8 +91,8 @@ Value<V> &Value<V>::operator=(const V &value)
 template<class V>
 void Value<V>::update()
 {
-    debug("update") << key() << ": have updater: " << (m_updater ? "yes" : "no") << ", value=" << entry()->value()
-                    << std::endl;
+    CONFIG_DEBUG("update") << key() << ": have updater: " << (m_updater ? "yes" : "no")
+                           << ", value=" << entry()->value() << std::endl;
     if (m_updater)
         m_updater(entry()->value());
 }
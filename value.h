@@ -6,6 +6,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <functional>
 #include "detail/export.h"
 #include "detail/flags.h"
@@ -31,29 +32,31 @@ Boolean (`bool`), integral (`int64_t`), floating point (`double`) and string (`s
 */
 template<class V>
 class Value: public ConfigBase {
+    friend class Access;
     friend class detail::ValueEntry<V>;
 
 public:
     Value() = delete;
     Value(const Value &other) =
         delete; ///< removed as copying does not work well when functor objects are provided via \ref setUpdater
-    Value(const std::string &path, const std::string &section, const std::string &name,
+    Value(std::string_view path, std::string_view section, std::string_view name,
           detail::Manager *mgr = nullptr); ///< create from an existing entry managed by mgr (or the default manager)
-    Value(const std::string &path, const std::string &section, const std::string &name, const V &value,
+    Value(std::string_view path, std::string_view section, std::string_view name, const V &value,
           detail::Manager *mgr = nullptr,
           Flag flags =
               Flag::Default); ///< create new entry with default value, must match default and flags at other locations
     ~Value() override;
     void setUpdater(std::function<void(const V &)> func); ///< set `func` to be notified when value changes
-    const V &value() const; ///< retrieve value
+    const V &value() const; ///< retrieve value, not to be called while other threads assign
+    V snapshot() const; ///< retrieve copy of value, may be called while other threads assign
     const V &defaultValue() const; ///< retrieve default value
-    operator V() const; ///< retrieve value
+    operator V() const; ///< retrieve copy of value, may be called while other threads assign
     Value &operator=(const V &value); ///< assign a new value
 
 private:
     Value(detail::ValueEntry<V> *entry); ///< create from a provided existing entry where data is stored
     Value(detail::ValueEntry<V> *parent, const std::string &subsection,
-          const std::string &name); ///< create from a provided existing entry where data is stored
+          std::string_view name); ///< create from a provided existing entry where data is stored
 
     void update() override; ///< called when value is changed
     detail::ValueEntry<V> *entry() const; ///< access storage of value